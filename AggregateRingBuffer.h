@@ -0,0 +1,204 @@
+#pragma once
+
+#include "SimpleRingBuffer.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ArcdpsExtension {
+	/**
+	 * Aggregate policy for `AggregateRingBuffer`: the smallest (`Compare` = `std::less<>`) or largest element.
+	 * Keeps a monotonic deque, so `Push` is amortized O(1) and `Value` is O(1).
+	 */
+	template<typename T, typename Compare>
+	class RingExtremum {
+	public:
+		void Push(const T& pElement) {
+			// everything that is not better than the new element can never become the extremum again
+			while (!mCandidates.empty() && !mCompare(mCandidates.back().Value, pElement)) {
+				mCandidates.pop_back();
+			}
+			mCandidates.push_back({pElement, mPushed++});
+		}
+
+		void Evict(const T&) {
+			if (!mCandidates.empty() && mCandidates.front().Sequence == mEvicted) {
+				mCandidates.pop_front();
+			}
+			++mEvicted;
+		}
+
+		void Clear() {
+			mCandidates.clear();
+			mPushed = 0;
+			mEvicted = 0;
+		}
+
+		[[nodiscard]] const T& Value() const {
+			assert(!mCandidates.empty() && "called on an empty buffer");
+			return mCandidates.front().Value;
+		}
+
+	private:
+		struct Candidate {
+			T Value;
+			uint64_t Sequence;
+		};
+
+		std::deque<Candidate> mCandidates;
+		uint64_t mPushed = 0;
+		uint64_t mEvicted = 0;
+		[[no_unique_address]] Compare mCompare;
+	};
+
+	template<typename T>
+	using RingMin = RingExtremum<T, std::less<>>;
+
+	template<typename T>
+	using RingMax = RingExtremum<T, std::greater<>>;
+
+	/**
+	 * Aggregate policy for `AggregateRingBuffer`: running sum.
+	 * With floating point types the sum can drift a little over time, since every evicted element is subtracted again.
+	 */
+	template<typename T, typename Sum = T>
+	class RingSum {
+	public:
+		void Push(const T& pElement) {
+			mSum += static_cast<Sum>(pElement);
+		}
+
+		void Evict(const T& pElement) {
+			mSum -= static_cast<Sum>(pElement);
+		}
+
+		void Clear() {
+			mSum = Sum{};
+		}
+
+		[[nodiscard]] const Sum& Value() const {
+			return mSum;
+		}
+
+	private:
+		Sum mSum{};
+	};
+
+	/**
+	 * `RingBuffer` that keeps aggregates over its content up to date on every push and eviction,
+	 * so the overlay does not have to iterate the whole buffer every frame.
+	 * Every policy needs `Push(const T&)`, `Evict(const T&)` and `Clear()`. It is accessible with `Get<Policy>()`.
+	 * `Min()`, `Max()`, `Sum()` and `Mean()` are available, when the matching policy is used.
+	 * <br>
+	 * Usage:
+	 * @code
+	 * AggregateRingBuffer<int64_t, RingMax<int64_t>, RingSum<int64_t>> dps(60);
+	 * dps.PushBack(damageThisSecond);
+	 * ImGui::Text("peak %lld, avg %f", dps.Max(), dps.Mean());
+	 * @endcode
+	 *
+	 * @tparam T The type that this buffer holds.
+	 * @tparam Policies The aggregates to maintain.
+	 */
+	template<typename T, typename... Policies>
+	class AggregateRingBuffer {
+	public:
+		explicit AggregateRingBuffer(size_t pCapacity) : mBuffer(pCapacity, mPolicies) {}
+
+		// the buffer refers to mPolicies
+		AggregateRingBuffer(const AggregateRingBuffer& pOther) = delete;
+		AggregateRingBuffer(AggregateRingBuffer&& pOther) noexcept = delete;
+		AggregateRingBuffer& operator=(const AggregateRingBuffer& pOther) = delete;
+		AggregateRingBuffer& operator=(AggregateRingBuffer&& pOther) noexcept = delete;
+
+		void PushBack(const T& pElement) {
+			mBuffer.PushBack(pElement);
+			push(mBuffer.Back());
+		}
+
+		void PushBack(T&& pElement) {
+			mBuffer.PushBack(std::move(pElement));
+			push(mBuffer.Back());
+		}
+
+		template<typename... Args>
+		void EmplaceBack(const Args&... args) {
+			mBuffer.EmplaceBack(args...);
+			push(mBuffer.Back());
+		}
+
+		void Clear() {
+			mBuffer.Clear();
+			std::apply([](auto&... pPolicy) { (pPolicy.Clear(), ...); }, mPolicies);
+		}
+
+		template<typename Policy>
+		[[nodiscard]] const Policy& Get() const {
+			return std::get<Policy>(mPolicies);
+		}
+
+		[[nodiscard]] const T& Min() const
+			requires(std::is_same_v<RingMin<T>, Policies> || ...)
+		{
+			return Get<RingMin<T>>().Value();
+		}
+
+		[[nodiscard]] const T& Max() const
+			requires(std::is_same_v<RingMax<T>, Policies> || ...)
+		{
+			return Get<RingMax<T>>().Value();
+		}
+
+		[[nodiscard]] const T& Sum() const
+			requires(std::is_same_v<RingSum<T>, Policies> || ...)
+		{
+			return Get<RingSum<T>>().Value();
+		}
+
+		[[nodiscard]] double Mean() const
+			requires(std::is_same_v<RingSum<T>, Policies> || ...)
+		{
+			return mBuffer.Size() > 0 ? static_cast<double>(Sum()) / static_cast<double>(mBuffer.Size()) : 0.;
+		}
+
+		[[nodiscard]] const T& Back() const { return mBuffer.Back(); }
+		[[nodiscard]] const T& operator[](size_t pNum) const { return mBuffer[pNum]; }
+		[[nodiscard]] size_t Size() const { return mBuffer.Size(); }
+		[[nodiscard]] auto Segments() const { return mBuffer.Segments(); }
+
+		// elements are only accessible as const, changing them would invalidate the aggregates
+		auto begin() const { return mBuffer.begin(); }
+		auto end() const { return mBuffer.end(); }
+
+	private:
+		using PolicyTuple = std::tuple<Policies...>;
+
+		class EvictingBuffer : public RingBuffer<T> {
+		public:
+			EvictingBuffer(size_t pCapacity, PolicyTuple& pPolicies) : RingBuffer<T>(pCapacity), mPolicies(pPolicies) {
+				this->EnableOnEvict();
+			}
+
+		protected:
+			void OnEvict(T& pElement) override {
+				std::apply([&pElement](auto&... pPolicy) { (pPolicy.Evict(pElement), ...); }, mPolicies);
+			}
+
+		private:
+			PolicyTuple& mPolicies;
+		};
+
+		PolicyTuple mPolicies;
+		EvictingBuffer mBuffer;
+
+		void push(const T& pElement) {
+			std::apply([&pElement](auto&... pPolicy) { (pPolicy.Push(pElement), ...); }, mPolicies);
+		}
+	};
+} // namespace ArcdpsExtension
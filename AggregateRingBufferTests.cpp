@@ -0,0 +1,71 @@
+#include "AggregateRingBuffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace ArcdpsExtension;
+
+TEST(AggregateRingBufferTests, MinMaxSumTest) {
+	AggregateRingBuffer<int64_t, RingMin<int64_t>, RingMax<int64_t>, RingSum<int64_t>> buffer(3);
+	buffer.PushBack(5);
+	EXPECT_EQ(buffer.Min(), 5);
+	EXPECT_EQ(buffer.Max(), 5);
+
+	buffer.PushBack(1);
+	buffer.PushBack(9);
+	EXPECT_EQ(buffer.Min(), 1);
+	EXPECT_EQ(buffer.Max(), 9);
+	EXPECT_EQ(buffer.Sum(), 15);
+	EXPECT_EQ(buffer.Mean(), 5.);
+
+	// 5 is evicted
+	buffer.PushBack(2);
+	EXPECT_EQ(buffer.Min(), 1);
+	EXPECT_EQ(buffer.Sum(), 12);
+
+	// 1 is evicted
+	buffer.EmplaceBack(3);
+	EXPECT_EQ(buffer.Min(), 2);
+	EXPECT_EQ(buffer.Max(), 9);
+
+	// 9 is evicted
+	buffer.PushBack(4);
+	EXPECT_EQ(buffer.Max(), 4);
+	EXPECT_EQ(buffer.Sum(), 9);
+
+	buffer.Clear();
+	EXPECT_EQ(buffer.Size(), 0);
+	EXPECT_EQ(buffer.Sum(), 0);
+	buffer.PushBack(7);
+	EXPECT_EQ(buffer.Min(), 7);
+	EXPECT_EQ(buffer.Max(), 7);
+}
+
+TEST(AggregateRingBufferTests, RandomTest) {
+	AggregateRingBuffer<int64_t, RingMin<int64_t>, RingMax<int64_t>, RingSum<int64_t>> buffer(16);
+	std::mt19937 random(42);
+	std::uniform_int_distribution<int64_t> distribution(-1000, 1000);
+
+	for (int i = 0; i < 1000; ++i) {
+		buffer.PushBack(distribution(random));
+
+		std::vector<int64_t> content(buffer.begin(), buffer.end());
+		ASSERT_EQ(buffer.Min(), std::ranges::min(content));
+		ASSERT_EQ(buffer.Max(), std::ranges::max(content));
+		ASSERT_EQ(buffer.Sum(), std::accumulate(content.begin(), content.end(), int64_t{0}));
+	}
+}
+
+TEST(AggregateRingBufferTests, CustomPolicyTest) {
+	// sum in a wider type than the elements
+	using WideSum = RingSum<uint8_t, uint64_t>;
+	AggregateRingBuffer<uint8_t, WideSum> buffer(4);
+	for (int i = 0; i < 10; ++i) {
+		buffer.PushBack(200);
+	}
+	EXPECT_EQ(buffer.Get<WideSum>().Value(), 800);
+}
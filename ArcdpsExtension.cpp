@@ -6,6 +6,8 @@
 
 #if ARCDPS_EXTENSION_CURL
 #include "SimpleNetworkStack.h"
+
+#include <filesystem>
 #endif
 
 #if ARCDPS_EXTENSION_IMGUI
@@ -27,7 +29,8 @@ void ArcdpsExtension::Setup(HMODULE pDll, ID3D11Device* pD11Device) {
 	Localization::instance();
 
 #if ARCDPS_EXTENSION_CURL
-	SimpleNetworkStack::instance();
+	// same base directory as the icon downloads of the `IconLoader`
+	SimpleNetworkStack::instance().SetCacheDirectory(std::filesystem::temp_directory_path() / "GW2-arcdps-extension" / "http-cache");
 #endif
 
 	// needs imgui
@@ -0,0 +1,145 @@
+#include "CastAttributor.h"
+
+#include <algorithm>
+#include <utility>
+
+ArcdpsExtension::CastAttributor::CastAttributor(HitFunc pCallback, uint64_t pMaxAge, size_t pMaxAgents)
+	: mCallback(std::move(pCallback)), mMaxAge(pMaxAge), mMaxAgents(std::max<size_t>(pMaxAgents, 1)) {}
+
+void ArcdpsExtension::CastAttributor::Activation(const cbtevent& pEvent) {
+	if (pEvent.is_activation == ACTV_NONE) {
+		return;
+	}
+
+	// activations are sent when the cast ends, value is the duration of the cast
+	Cast cast;
+	cast.EndTime = pEvent.time;
+	cast.StartTime = pEvent.value > 0 && static_cast<uint64_t>(pEvent.value) <= pEvent.time ? pEvent.time - pEvent.value : pEvent.time;
+	cast.Kind = pEvent.is_activation;
+
+	AgentWindow& window = this->window(pEvent.src_agent, pEvent.time);
+	window.Casts[window.NextCast] = {pEvent.skillid, cast};
+	window.NextCast = (window.NextCast + 1) % CastWindow;
+
+	// claim pending hits that happened during this cast
+	for (auto& pending : window.Pending) {
+		if (pending && pending->SkillId == pEvent.skillid && pending->Time >= cast.StartTime && pending->Time <= cast.EndTime) {
+			pending->Activation = cast;
+			mCallback(*pending);
+			pending.reset();
+		}
+	}
+}
+
+void ArcdpsExtension::CastAttributor::Strike(const cbtevent& pEvent) {
+	hit(pEvent, pEvent.value, false);
+}
+
+void ArcdpsExtension::CastAttributor::BuffDamage(const cbtevent& pEvent) {
+	hit(pEvent, pEvent.buff_dmg, true);
+}
+
+void ArcdpsExtension::CastAttributor::Flush() {
+	for (auto& [agent, window] : mAgents) {
+		for (auto& pending : window.Pending) {
+			resolve(window, pending);
+		}
+	}
+	mAgents.clear();
+	mNow = 0;
+	mNextSweep = 0;
+}
+
+void ArcdpsExtension::CastAttributor::hit(const cbtevent& pEvent, int32_t pDamage, bool pBuffDamage) {
+	AgentWindow& window = this->window(pEvent.src_agent, pEvent.time);
+
+	Hit element;
+	element.Time = pEvent.time;
+	element.SourceAgent = pEvent.src_agent;
+	element.DestinationAgent = pEvent.dst_agent;
+	element.SkillId = pEvent.skillid;
+	element.Damage = pDamage;
+	element.Result = pEvent.result;
+	element.BuffDamage = pBuffDamage;
+
+	// hit during a known cast
+	if (const CastEntry* cast = findCast(window, pEvent.skillid, pEvent.time, 0)) {
+		element.Activation = cast->Value;
+		mCallback(element);
+		return;
+	}
+
+	// wait for the cast to end, push out the oldest pending hit, if there is no space left
+	auto& slot = window.Pending[window.NextPending];
+	resolve(window, slot);
+	slot = element;
+	window.NextPending = (window.NextPending + 1) % PendingWindow;
+}
+
+ArcdpsExtension::CastAttributor::AgentWindow& ArcdpsExtension::CastAttributor::window(uintptr_t pAgent, uint64_t pTime) {
+	mNow = std::max(mNow, pTime);
+	// sweeping all agents once per `MaxAge` keeps the cost per event constant
+	if (mNow >= mNextSweep) {
+		sweep();
+		mNextSweep = mNow + std::max<uint64_t>(mMaxAge, 1);
+	}
+
+	auto it = mAgents.find(pAgent);
+	if (it == mAgents.end()) {
+		if (mAgents.size() >= mMaxAgents) {
+			evictOldest();
+		}
+		it = mAgents.try_emplace(pAgent).first;
+	}
+	it->second.LastSeen = std::max(it->second.LastSeen, pTime);
+	return it->second;
+}
+
+void ArcdpsExtension::CastAttributor::sweep() {
+	for (auto it = mAgents.begin(); it != mAgents.end();) {
+		AgentWindow& window = it->second;
+		// pending hits that are too old will never get a cast anymore
+		for (auto& pending : window.Pending) {
+			if (pending && pending->Time + mMaxAge < mNow) {
+				resolve(window, pending);
+			}
+		}
+
+		// none of its casts can match a new hit anymore, and all its pending hits are resolved by now
+		if (window.LastSeen + mMaxAge < mNow) {
+			it = mAgents.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void ArcdpsExtension::CastAttributor::evictOldest() {
+	auto oldest = std::ranges::min_element(mAgents, {}, [](const auto& pEntry) { return pEntry.second.LastSeen; });
+	for (auto& pending : oldest->second.Pending) {
+		resolve(oldest->second, pending);
+	}
+	mAgents.erase(oldest);
+}
+
+void ArcdpsExtension::CastAttributor::resolve(const AgentWindow& pWindow, std::optional<Hit>& pHit) {
+	if (!pHit) {
+		return;
+	}
+	if (const CastEntry* cast = findCast(pWindow, pHit->SkillId, pHit->Time, mMaxAge)) {
+		pHit->Activation = cast->Value;
+	}
+	mCallback(*pHit);
+	pHit.reset();
+}
+
+const ArcdpsExtension::CastAttributor::CastEntry* ArcdpsExtension::CastAttributor::findCast(const AgentWindow& pWindow, uint32_t pSkillId, uint64_t pTime, uint64_t pTolerance) const {
+	// newest first
+	for (size_t i = 1; i <= CastWindow; ++i) {
+		const CastEntry& entry = pWindow.Casts[(pWindow.NextCast + CastWindow - i) % CastWindow];
+		if (entry.Value.Kind != ACTV_NONE && entry.SkillId == pSkillId && entry.Value.StartTime <= pTime && pTime <= entry.Value.EndTime + pTolerance) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
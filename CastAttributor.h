@@ -0,0 +1,98 @@
+#pragma once
+
+#include "arcdps_structs_slim.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+
+namespace ArcdpsExtension {
+	/**
+	 * Streaming join of `Strike`/`BuffDamage` events with the `Activation` (skill cast) that caused them.
+	 * Every source agent has a small ring of its latest casts and a small ring of hits that did not find a cast yet.
+	 * Both rings have a fixed size, so matching is constant time and memory stays constant per agent, no matter how long the fight is.
+	 * Agents without events for `MaxAge` are forgotten, and at most `MaxAgents` agents are tracked at once (the least recently seen is dropped first),
+	 * so memory also stays bounded outside a log, where `Flush()` is never called.
+	 * <br>
+	 * Arcdps sends activation events when the cast ends, so hits during a cast are emitted as soon as the cast arrives. Hits after the end of a cast are kept pending until they are
+	 * pushed out of the pending ring, get older than `MaxAge` (measured against the latest event of any agent) or `Flush()` is called. Then they are matched with the latest cast
+	 * that ended at most `MaxAge` before. Every hit is emitted exactly once, but not necessarily in order.
+	 * <br>
+	 * Hits from minions are not attributed to the casts of their master.
+	 */
+	class CastAttributor {
+	public:
+		static constexpr size_t CastWindow = 8;
+		static constexpr size_t PendingWindow = 16;
+		static constexpr uint64_t DefaultMaxAge = 3000;
+		static constexpr size_t DefaultMaxAgents = 256;
+
+		struct Cast {
+			uint64_t StartTime = 0;
+			uint64_t EndTime = 0;
+			cbtactivation Kind = ACTV_NONE;
+		};
+
+		struct Hit {
+			uint64_t Time = 0;
+			uintptr_t SourceAgent = 0;
+			uintptr_t DestinationAgent = 0;
+			uint32_t SkillId = 0;
+			int32_t Damage = 0;
+			uint8_t Result = 0;
+			bool BuffDamage = false;
+			std::optional<Cast> Activation; // empty if no cast was found
+		};
+
+		using HitFunc = std::function<void(const Hit&)>;
+
+		/**
+		 * @param pCallback Called for every attributed or unattributed hit
+		 * @param pMaxAge Max time in ms between the end of a cast and a hit of it (e.g. for projectile travel time).
+		 * @param pMaxAgents Max number of agents that are tracked at once.
+		 */
+		explicit CastAttributor(HitFunc pCallback, uint64_t pMaxAge = DefaultMaxAge, size_t pMaxAgents = DefaultMaxAgents);
+
+		void Activation(const cbtevent& pEvent);
+		void Strike(const cbtevent& pEvent);
+		void BuffDamage(const cbtevent& pEvent);
+
+		/**
+		 * Emit all pending hits and forget all agents. Call on LogEnd.
+		 */
+		void Flush();
+
+		[[nodiscard]] size_t AgentCount() const { return mAgents.size(); }
+
+	private:
+		struct CastEntry {
+			uint32_t SkillId = 0;
+			Cast Value;
+		};
+
+		struct AgentWindow {
+			std::array<CastEntry, CastWindow> Casts{};
+			std::array<std::optional<Hit>, PendingWindow> Pending{};
+			uint8_t NextCast = 0;
+			uint8_t NextPending = 0;
+			uint64_t LastSeen = 0;
+		};
+
+		HitFunc mCallback;
+		uint64_t mMaxAge;
+		size_t mMaxAgents;
+		std::unordered_map<uintptr_t, AgentWindow> mAgents;
+		uint64_t mNow = 0; // latest event time of any agent
+		uint64_t mNextSweep = 0;
+
+		[[nodiscard]] AgentWindow& window(uintptr_t pAgent, uint64_t pTime);
+		void sweep();
+		void evictOldest();
+		void hit(const cbtevent& pEvent, int32_t pDamage, bool pBuffDamage);
+		void resolve(const AgentWindow& pWindow, std::optional<Hit>& pHit);
+		[[nodiscard]] const CastEntry* findCast(const AgentWindow& pWindow, uint32_t pSkillId, uint64_t pTime, uint64_t pTolerance) const;
+	};
+} // namespace ArcdpsExtension
@@ -0,0 +1,137 @@
+#include "arcdps_structs_slim.h"
+#include "CastAttributor.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace ArcdpsExtension;
+
+namespace {
+	cbtevent MakeActivation(uint64_t pTime, uintptr_t pSource, uint32_t pSkillId, int32_t pDuration) {
+		cbtevent event{};
+		event.time = pTime;
+		event.src_agent = pSource;
+		event.skillid = pSkillId;
+		event.value = pDuration;
+		event.is_activation = ACTV_RESET;
+		return event;
+	}
+
+	cbtevent MakeStrike(uint64_t pTime, uintptr_t pSource, uint32_t pSkillId, int32_t pDamage) {
+		cbtevent event{};
+		event.time = pTime;
+		event.src_agent = pSource;
+		event.dst_agent = 99;
+		event.skillid = pSkillId;
+		event.value = pDamage;
+		event.result = CBTR_STRIKE_DAMAGECRIT;
+		return event;
+	}
+} // namespace
+
+class CastAttributorTests : public ::testing::Test {
+protected:
+	std::vector<CastAttributor::Hit> mHits;
+	CastAttributor mAttributor{[this](const CastAttributor::Hit& pHit) { mHits.push_back(pHit); }, 1000};
+};
+
+TEST_F(CastAttributorTests, HitDuringCast) {
+	mAttributor.Strike(MakeStrike(1200, 1, 5, 300));
+	EXPECT_TRUE(mHits.empty()); // waiting for the cast to end
+
+	mAttributor.Activation(MakeActivation(1500, 1, 5, 600));
+	ASSERT_EQ(mHits.size(), 1);
+	EXPECT_EQ(mHits[0].Damage, 300);
+	EXPECT_EQ(mHits[0].DestinationAgent, 99);
+	EXPECT_EQ(mHits[0].Result, CBTR_STRIKE_DAMAGECRIT);
+	ASSERT_TRUE(mHits[0].Activation.has_value());
+	EXPECT_EQ(mHits[0].Activation->StartTime, 900);
+	EXPECT_EQ(mHits[0].Activation->EndTime, 1500);
+}
+
+TEST_F(CastAttributorTests, HitDuringKnownCast) {
+	mAttributor.Activation(MakeActivation(1500, 1, 5, 600));
+	mAttributor.Strike(MakeStrike(1000, 1, 5, 300));
+	ASSERT_EQ(mHits.size(), 1);
+	EXPECT_TRUE(mHits[0].Activation.has_value());
+}
+
+TEST_F(CastAttributorTests, HitAfterCast) {
+	mAttributor.Activation(MakeActivation(1500, 1, 5, 600));
+	mAttributor.BuffDamage(MakeStrike(1800, 1, 5, 0));
+	EXPECT_TRUE(mHits.empty());
+
+	mAttributor.Flush();
+	ASSERT_EQ(mHits.size(), 1);
+	EXPECT_TRUE(mHits[0].BuffDamage);
+	ASSERT_TRUE(mHits[0].Activation.has_value());
+	EXPECT_EQ(mHits[0].Activation->EndTime, 1500);
+}
+
+TEST_F(CastAttributorTests, NoMatch) {
+	mAttributor.Activation(MakeActivation(1500, 1, 5, 600));
+	// other skill
+	mAttributor.Strike(MakeStrike(1000, 1, 6, 300));
+	// other agent
+	mAttributor.Strike(MakeStrike(1000, 2, 5, 300));
+	// too long after the cast
+	mAttributor.Strike(MakeStrike(2600, 1, 5, 300));
+	mAttributor.Flush();
+
+	ASSERT_EQ(mHits.size(), 3);
+	for (const auto& hit : mHits) {
+		EXPECT_FALSE(hit.Activation.has_value());
+	}
+}
+
+TEST_F(CastAttributorTests, PendingExpires) {
+	mAttributor.Strike(MakeStrike(1000, 1, 5, 300));
+	mAttributor.Strike(MakeStrike(1500, 1, 6, 300));
+	EXPECT_TRUE(mHits.empty());
+
+	// the first hit is older than MaxAge now
+	mAttributor.Strike(MakeStrike(2100, 1, 6, 300));
+	ASSERT_EQ(mHits.size(), 1);
+	EXPECT_EQ(mHits[0].SkillId, 5);
+	EXPECT_FALSE(mHits[0].Activation.has_value());
+}
+
+TEST_F(CastAttributorTests, BoundedWindow) {
+	for (uint64_t i = 0; i < CastAttributor::PendingWindow * 3; ++i) {
+		mAttributor.Strike(MakeStrike(1000 + i, 1, 5, 300));
+	}
+	EXPECT_EQ(mHits.size(), CastAttributor::PendingWindow * 2);
+
+	mAttributor.Flush();
+	EXPECT_EQ(mHits.size(), CastAttributor::PendingWindow * 3);
+}
+
+TEST_F(CastAttributorTests, IdleAgentsForgotten) {
+	for (uintptr_t agent = 1; agent <= 100; ++agent) {
+		mAttributor.Strike(MakeStrike(1000, agent, 5, 300));
+	}
+	EXPECT_EQ(mAttributor.AgentCount(), 100);
+	EXPECT_TRUE(mHits.empty());
+
+	// another agent moves the time forward, pending hits of the idle agents expire without an event of their own
+	mAttributor.Activation(MakeActivation(2500, 200, 7, 100));
+	EXPECT_EQ(mHits.size(), 100);
+	EXPECT_EQ(mAttributor.AgentCount(), 1);
+}
+
+TEST(CastAttributorLimitTests, MaxAgents) {
+	std::vector<CastAttributor::Hit> hits;
+	CastAttributor attributor([&hits](const CastAttributor::Hit& pHit) { hits.push_back(pHit); }, 1000, 4);
+
+	for (uintptr_t agent = 1; agent <= 10; ++agent) {
+		attributor.Strike(MakeStrike(1000 + agent, agent, 5, 300));
+		EXPECT_LE(attributor.AgentCount(), 4);
+	}
+	// the pending hits of the dropped agents were emitted
+	ASSERT_EQ(hits.size(), 6);
+	EXPECT_EQ(hits[0].SourceAgent, 1);
+
+	attributor.Flush();
+	EXPECT_EQ(hits.size(), 10);
+}
@@ -15,6 +15,10 @@ void ArcdpsExtension::CombatEventHandler::EventInternal(cbtevent* pEvent, ag* pS
 	if (pEvent) {
 		mLastEventTime = pEvent->time;
 
+		if (!pEvent->is_statechange && pEvent->skillid != 0) {
+			mSkillTable.Observe(pEvent->skillid, pSkillname);
+		}
+
 		if (pEvent->is_statechange) {
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wswitch"
@@ -38,10 +42,17 @@ void ArcdpsExtension::CombatEventHandler::EventInternal(cbtevent* pEvent, ag* pS
 					//                case CBTS_DESPAWN: // Not in realtime api
 					//                case CBTS_HEALTHUPDATE: // Not in realtime api
 				case CBTS_SQCOMBATSTART:
+					mEncounterArena.Open();
+					mCurrentEncounter = ClassifyEncounter(pEvent->src_agent);
 					LogStart(mLastEventTime, pEvent->value, pEvent->buff_dmg, pEvent->src_agent);
 					break;
 				case CBTS_SQCOMBATEND:
+					if (mCastAttributor) {
+						mCastAttributor->Flush();
+					}
 					LogEnd(mLastEventTime, pEvent->value, pEvent->buff_dmg, pEvent->src_agent);
+					mEncounterArena.Close();
+					mCurrentEncounter = {};
 					break;
 				case CBTS_WEAPSWAP:
 					WeaponSwap(mLastEventTime, pEvent->src_agent, static_cast<WeaponSet>(pEvent->dst_agent), *pSrc);
@@ -94,6 +105,7 @@ void ArcdpsExtension::CombatEventHandler::EventInternal(cbtevent* pEvent, ag* pS
 					//                case CBTS_BARRIERUPDATE: // Not in realtime api
 				case CBTS_STATRESET_DEFUNC:
 					StatReset(mLastEventTime);
+					mEncounterArena.Release();
 					break;
 				case CBTS_EXTENSION:
 					Extension(mLastEventTime, pEvent, pSrc, pDst, pSkillname, pId);
@@ -113,10 +125,16 @@ void ArcdpsExtension::CombatEventHandler::EventInternal(cbtevent* pEvent, ag* pS
 					//                case CBTS_EFFECT: // Not in realtime api
 					//                case CBTS_IDTOGUID: // Not in realtime api
 				case CBTS_LOGNPCUPDATE:
+					if (auto encounter = ClassifyEncounter(pEvent->src_agent); encounter.Id != Encounter::Unknown) {
+						mCurrentEncounter = encounter;
+					}
 					LogNpcUpdate(mLastEventTime, static_cast<uint32_t>(pEvent->value), static_cast<uint32_t>(pEvent->buff_dmg), pEvent->src_agent);
 			}
 #pragma clang diagnostic pop
 		} else if (pEvent->is_activation) {
+			if (mCastAttributor) {
+				mCastAttributor->Activation(*pEvent);
+			}
 			Activation(mLastEventTime, pEvent, *pSrc, *pDst, pSkillname, pId);
 		} else if (pEvent->is_buffremove) {
 			auto pad = reinterpret_cast<uint32_t*>(&pEvent->pad61);
@@ -125,6 +143,9 @@ void ArcdpsExtension::CombatEventHandler::EventInternal(cbtevent* pEvent, ag* pS
 			BuffEvent(pEvent, pSrc, pDst, pSkillname, pId);
 		} else {
 			// Strike damage
+			if (mCastAttributor) {
+				mCastAttributor->Strike(*pEvent);
+			}
 			Strike(mLastEventTime, pEvent, *pSrc, *pDst, pSkillname, pId);
 		}
 	}
@@ -161,6 +182,9 @@ void ArcdpsExtension::CombatEventHandler::EventInternal(cbtevent* pEvent, ag* pS
 
 void ArcdpsExtension::CombatEventHandler::BuffEvent(cbtevent* pEvent, ag* pSrc, ag* pDst, const char* pSkillname, uint64_t pId) {
 	if (pEvent->buff_dmg) {
+		if (mCastAttributor) {
+			mCastAttributor->BuffDamage(*pEvent);
+		}
 		BuffDamage(mLastEventTime, pEvent, *pSrc, *pDst, pSkillname, pId);
 	} else {
 		// Buff apply event
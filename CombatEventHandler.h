@@ -1,10 +1,15 @@
 #pragma once
 
 #include "arcdps_structs_slim.h"
+#include "CastAttributor.h"
+#include "EncounterArena.h"
+#include "Encounters.h"
 #include "EventSequencer.h"
+#include "SkillTable.h"
 
 #include <cstdint>
 #include <format>
+#include <optional>
 #include <string>
 
 namespace ArcdpsExtension {
@@ -27,6 +32,17 @@ namespace ArcdpsExtension {
 
 		bool EventsPending();
 
+		/**
+		 * All skills seen in events so far. Filled before the event callbacks are called.
+		 * Use `Import()` on it in `mod_init` to have names and metadata of skills from the last session.
+		 */
+		SkillTable& GetSkillTable() {
+			return mSkillTable;
+		}
+		const SkillTable& GetSkillTable() const {
+			return mSkillTable;
+		}
+
 		/**
 		 * Reset everything here aka. calls Reset on the sequencer.
 		 * This has no live api uses. Only use in tests!
@@ -40,6 +56,15 @@ namespace ArcdpsExtension {
 		}
 
 	protected:
+		/**
+		 * Join `Strike` and `BuffDamage` events with the `Activation` that caused them, results are given to `AttributedHit()`.
+		 * Disabled by default, call this in the constructor of the derived class.
+		 * @param pMaxAge Max time in ms between the end of a cast and a hit of it
+		 */
+		void EnableCastAttribution(uint64_t pMaxAge = CastAttributor::DefaultMaxAge) {
+			mCastAttributor.emplace([this](const CastAttributor::Hit& pHit) { AttributedHit(pHit); }, pMaxAge);
+		}
+
 		/**
 		 * All events will call this before they are handled.
 		 * If you decide to override this function, make sure to also call the parent one, else all other callbacks are never called.
@@ -133,6 +158,7 @@ namespace ArcdpsExtension {
 		}
 
 		/**
+		 * `mEncounterArena` is opened and `mCurrentEncounter` is set right before this is called.
 		 * @param pTime Time of the event (Windows timegettime function aka. time since startup)
 		 * @param pServerTime Current unix timestamp on the server (UTC)
 		 * @param pLocalTime Current unix timestamp of local user time
@@ -143,6 +169,7 @@ namespace ArcdpsExtension {
 		}
 
 		/**
+		 * `mEncounterArena` is released right after this returns, destroy everything allocated from it in here.
 		 * @param pTime Time of the event (Windows timegettime function aka. time since startup)
 		 * @param pServerTime Current unix timestamp on the server (UTC)
 		 * @param pLocalTime Current unix timestamp of local user time
@@ -153,6 +180,7 @@ namespace ArcdpsExtension {
 		}
 
 		/**
+		 * `mCurrentEncounter` is updated right before this is called, if the species belongs to a known encounter.
 		 * @param pTime Time of the event (Windows timegettime function aka. time since startup)
 		 * @param pServerTime Current unix timestamp on the server (UTC)
 		 * @param pLocalTime Current unix timestamp of local user time
@@ -220,6 +248,7 @@ namespace ArcdpsExtension {
 		 * src_agent: species id of agent that triggered the reset, eg boss species id
 		 * evtc: yes
 		 * realtime: yes
+		 * `mEncounterArena` is released right after this returns, destroy everything allocated from it in here.
 		 * @param pTime Time of the event (Windows timegettime function aka. time since startup)
 		 */
 		virtual void StatReset(uint64_t pTime) {
@@ -320,6 +349,15 @@ namespace ArcdpsExtension {
 			Log("Strike");
 		}
 
+		/**
+		 * A Strike or BuffDamage together with the cast that caused it (if one was found).
+		 * Only called after `EnableCastAttribution()`. Hits that are still pending are given out before `LogEnd` is called.
+		 * See `CastAttributor` for details.
+		 */
+		virtual void AttributedHit(const CastAttributor::Hit& pHit) {
+			Log("AttributedHit");
+		}
+
 		virtual void BuffInitial(uint64_t pTime, cbtevent* pEvent, const ag& pSrc, const ag& pDst, const char* pSkillname, uint64_t pId, uint32_t pStackId) {
 			Log("BuffInitial");
 		}
@@ -331,8 +369,22 @@ namespace ArcdpsExtension {
 		 */
 		uint64_t mLastEventTime = 0;
 
+		/**
+		 * Memory for per-encounter state. Opened on LogStart, released after LogEnd and StatReset.
+		 * Only use it from within the event callbacks.
+		 */
+		EncounterArena mEncounterArena;
+
+		/**
+		 * Encounter of the current log, classified from the species id of LogStart/LogNpcUpdate. Reset after LogEnd.
+		 * Use it to switch per-fight behavior: `switch (mCurrentEncounter.Id) {...}`
+		 */
+		EncounterClassification mCurrentEncounter;
+
 	private:
 		EventSequencer mSequencer;
+		SkillTable mSkillTable;
+		std::optional<CastAttributor> mCastAttributor;
 
 		void BuffEvent(cbtevent* pEvent, ag* pSrc, ag* pDst, const char* pSkillname, uint64_t pId);
 	};
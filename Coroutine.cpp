@@ -0,0 +1,39 @@
+#include "Coroutine.h"
+
+void ArcdpsExtension::QueueExecutor::Post(std::coroutine_handle<> pHandle) {
+	{
+		std::lock_guard lock(mMutex);
+		mQueue.emplace_back(pHandle);
+	}
+	mCv.notify_one();
+}
+
+size_t ArcdpsExtension::QueueExecutor::RunPending() {
+	std::deque<std::coroutine_handle<>> pending;
+	{
+		std::lock_guard lock(mMutex);
+		pending.swap(mQueue);
+	}
+	// resumed without the lock, the coroutines post again or suspend on another executor
+	for (auto handle : pending) {
+		handle.resume();
+	}
+	return pending.size();
+}
+
+void ArcdpsExtension::QueueExecutor::Run(const std::stop_token& pToken) {
+	while (!pToken.stop_requested()) {
+		{
+			std::unique_lock lock(mMutex);
+			if (!mCv.wait(lock, pToken, [this] { return !mQueue.empty(); })) {
+				break;
+			}
+		}
+		RunPending();
+	}
+}
+
+size_t ArcdpsExtension::QueueExecutor::Pending() const {
+	std::lock_guard lock(mMutex);
+	return mQueue.size();
+}
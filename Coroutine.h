@@ -0,0 +1,257 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <utility>
+
+namespace ArcdpsExtension {
+	/**
+	 * Decides on which thread a suspended coroutine continues.
+	 * Awaitables that complete on another thread (like `SimpleNetworkStack::Get`) post the coroutine here,
+	 * instead of resuming it on that thread.
+	 */
+	class Executor {
+	public:
+		virtual ~Executor() = default;
+
+		/**
+		 * Resume `pHandle` later, on the thread(s) of this executor. Has to be thread-safe.
+		 */
+		virtual void Post(std::coroutine_handle<> pHandle) = 0;
+
+		/**
+		 * Continue the current coroutine on this executor.
+		 * <br>
+		 * Usage:
+		 * @code
+		 * co_await uiExecutor.Schedule();
+		 * // runs on the thread that calls `uiExecutor.RunPending()`
+		 * @endcode
+		 */
+		[[nodiscard]] auto Schedule() {
+			struct ScheduleAwaiter {
+				Executor& mExecutor;
+
+				bool await_ready() const noexcept { return false; }
+				void await_suspend(std::coroutine_handle<> pHandle) { mExecutor.Post(pHandle); }
+				void await_resume() const noexcept {}
+			};
+			return ScheduleAwaiter{*this};
+		}
+	};
+
+	/**
+	 * Executor that collects coroutines and resumes them on whichever thread runs it.
+	 * Either call `RunPending()` regularly from an existing loop (e.g. once per frame),
+	 * or give it a thread of its own with `Run()`.
+	 * <br>
+	 * Coroutines that are still queued when the executor is destroyed are never resumed, their frames leak.
+	 */
+	class QueueExecutor final : public Executor {
+	public:
+		void Post(std::coroutine_handle<> pHandle) override;
+
+		/**
+		 * Resume all coroutines that are queued right now. Coroutines posted while they run wait for the next call.
+		 * @return Number of resumed coroutines.
+		 */
+		size_t RunPending();
+
+		/**
+		 * Resume coroutines as they are posted, until `pToken` is stopped.
+		 */
+		void Run(const std::stop_token& pToken);
+
+		[[nodiscard]] size_t Pending() const;
+
+	private:
+		std::deque<std::coroutine_handle<>> mQueue;
+		mutable std::mutex mMutex;
+		std::condition_variable_any mCv;
+	};
+
+	template<typename T = void>
+	class Task;
+
+	namespace Detail {
+		class TaskPromiseBase {
+		public:
+			struct FinalAwaiter {
+				bool await_ready() const noexcept { return false; }
+
+				template<typename Promise>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> pHandle) noexcept {
+					TaskPromiseBase& promise = pHandle.promise();
+					if (promise.mDetached) {
+						pHandle.destroy();
+						return std::noop_coroutine();
+					}
+					// symmetric transfer, in optimized builds resuming a chain of tasks doesn't grow the stack
+					return promise.mContinuation ? promise.mContinuation : std::noop_coroutine();
+				}
+
+				void await_resume() const noexcept {}
+			};
+
+			std::suspend_always initial_suspend() noexcept { return {}; }
+			FinalAwaiter final_suspend() noexcept { return {}; }
+
+			void unhandled_exception() {
+				// like an exception leaving a `std::thread`, there is no one to hand it to
+				if (mDetached) {
+					std::terminate();
+				}
+				mException = std::current_exception();
+			}
+
+			void SetContinuation(std::coroutine_handle<> pContinuation) { mContinuation = pContinuation; }
+			void Detach() { mDetached = true; }
+
+		protected:
+			void rethrow() const {
+				if (mException) {
+					std::rethrow_exception(mException);
+				}
+			}
+
+		private:
+			std::coroutine_handle<> mContinuation;
+			std::exception_ptr mException;
+			bool mDetached = false;
+		};
+
+		template<typename T>
+		class TaskPromise final : public TaskPromiseBase {
+		public:
+			Task<T> get_return_object() noexcept;
+
+			template<typename U = T>
+			void return_value(U&& pValue) {
+				mValue.emplace(std::forward<U>(pValue));
+			}
+
+			T Result() {
+				rethrow();
+				return std::move(*mValue);
+			}
+
+		private:
+			std::optional<T> mValue;
+		};
+
+		template<>
+		class TaskPromise<void> final : public TaskPromiseBase {
+		public:
+			Task<void> get_return_object() noexcept;
+
+			void return_void() noexcept {}
+
+			void Result() const {
+				rethrow();
+			}
+		};
+	} // namespace Detail
+
+	/**
+	 * Coroutine type for async flows, that `co_await` network requests or other tasks.
+	 * Tasks are lazy, they start when they are awaited or when `Start()` is called.
+	 * Where a task continues after a `co_await` depends on the awaited thing,
+	 * `SimpleNetworkStack::Get` continues on the given `Executor`.
+	 * <br>
+	 * Usage:
+	 * @code
+	 * Task<std::optional<std::string>> LatestVersion(QueueExecutor& pExecutor) {
+	 * 	auto release = co_await SimpleNetworkStack::instance().Get("https://api.github.com/repos/.../releases/latest", &pExecutor);
+	 * 	if (!release || release->Code != 200) {
+	 * 		co_return std::nullopt;
+	 * 	}
+	 * 	co_return ParseVersion(release->Message);
+	 * }
+	 *
+	 * Task<> CheckForUpdate(QueueExecutor& pExecutor) {
+	 * 	if (auto version = co_await LatestVersion(pExecutor)) {
+	 * 		...
+	 * 	}
+	 * }
+	 *
+	 * CheckForUpdate(executor).Start();
+	 * // in the UI loop
+	 * executor.RunPending();
+	 * @endcode
+	 */
+	template<typename T>
+	class [[nodiscard]] Task {
+	public:
+		using promise_type = Detail::TaskPromise<T>;
+
+		Task() = default;
+		explicit Task(std::coroutine_handle<promise_type> pHandle) : mHandle(pHandle) {}
+
+		~Task() {
+			if (mHandle) {
+				mHandle.destroy();
+			}
+		}
+
+		Task(const Task& pOther) = delete;
+		Task(Task&& pOther) noexcept : mHandle(std::exchange(pOther.mHandle, nullptr)) {}
+		Task& operator=(const Task& pOther) = delete;
+		Task& operator=(Task&& pOther) noexcept {
+			if (this != &pOther) {
+				if (mHandle) {
+					mHandle.destroy();
+				}
+				mHandle = std::exchange(pOther.mHandle, nullptr);
+			}
+			return *this;
+		}
+
+		/**
+		 * Run the task without awaiting it. It runs on the calling thread until its first suspension,
+		 * the coroutine frame is freed when it finishes. Exceptions leaving it call `std::terminate`.
+		 */
+		void Start() && {
+			auto handle = std::exchange(mHandle, nullptr);
+			handle.promise().Detach();
+			handle.resume();
+		}
+
+		[[nodiscard]] bool Valid() const noexcept { return static_cast<bool>(mHandle); }
+
+		auto operator co_await() && noexcept {
+			struct TaskAwaiter {
+				std::coroutine_handle<promise_type> mHandle;
+
+				bool await_ready() const noexcept { return false; }
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> pContinuation) noexcept {
+					mHandle.promise().SetContinuation(pContinuation);
+					return mHandle;
+				}
+
+				T await_resume() { return mHandle.promise().Result(); }
+			};
+			return TaskAwaiter{mHandle};
+		}
+
+	private:
+		std::coroutine_handle<promise_type> mHandle;
+	};
+
+	namespace Detail {
+		template<typename T>
+		Task<T> TaskPromise<T>::get_return_object() noexcept {
+			return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+		}
+
+		inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+			return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+		}
+	} // namespace Detail
+} // namespace ArcdpsExtension
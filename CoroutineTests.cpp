@@ -0,0 +1,99 @@
+#include "Coroutine.h"
+
+#include <future>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+using namespace ArcdpsExtension;
+
+namespace {
+	Task<int> Value(int pValue) {
+		co_return pValue;
+	}
+
+	Task<int> Count(int pCount) {
+		int count = 0;
+		for (int i = 0; i < pCount; ++i) {
+			count += co_await Value(1);
+		}
+		co_return count;
+	}
+
+	Task<std::string> Throwing() {
+		throw std::runtime_error("failed");
+		co_return "";
+	}
+
+	Task<> Store(Task<int> pTask, int& pResult) {
+		pResult = co_await std::move(pTask);
+	}
+} // namespace
+
+TEST(CoroutineTests, Lazy) {
+	int result = 0;
+	auto task = Store(Value(42), result);
+	EXPECT_TRUE(task.Valid());
+	EXPECT_EQ(result, 0);
+
+	std::move(task).Start();
+	EXPECT_FALSE(task.Valid());
+	EXPECT_EQ(result, 42);
+}
+
+TEST(CoroutineTests, AwaitChain) {
+	int result = 0;
+	Store(Count(1000), result).Start();
+	EXPECT_EQ(result, 1000);
+}
+
+TEST(CoroutineTests, Exception) {
+	bool caught = false;
+	[](bool& pCaught) -> Task<> {
+		try {
+			co_await Throwing();
+		} catch (const std::runtime_error&) {
+			pCaught = true;
+		}
+	}(caught).Start();
+	EXPECT_TRUE(caught);
+}
+
+TEST(CoroutineTests, RunPending) {
+	QueueExecutor executor;
+	int steps = 0;
+	[](QueueExecutor& pExecutor, int& pSteps) -> Task<> {
+		++pSteps;
+		co_await pExecutor.Schedule();
+		++pSteps;
+		co_await pExecutor.Schedule();
+		++pSteps;
+	}(executor, steps).Start();
+
+	EXPECT_EQ(steps, 1);
+	EXPECT_EQ(executor.Pending(), 1);
+	// the second `Schedule` is posted while running, it waits for the next call
+	EXPECT_EQ(executor.RunPending(), 1);
+	EXPECT_EQ(steps, 2);
+	EXPECT_EQ(executor.RunPending(), 1);
+	EXPECT_EQ(steps, 3);
+	EXPECT_EQ(executor.RunPending(), 0);
+}
+
+TEST(CoroutineTests, SwitchThread) {
+	QueueExecutor executor;
+	std::jthread thread([&executor](const std::stop_token& pToken) {
+		executor.Run(pToken);
+	});
+
+	std::promise<std::thread::id> promise;
+	auto future = promise.get_future();
+	[](QueueExecutor& pExecutor, std::promise<std::thread::id>& pPromise) -> Task<> {
+		co_await pExecutor.Schedule();
+		pPromise.set_value(std::this_thread::get_id());
+	}(executor, promise).Start();
+
+	EXPECT_EQ(future.get(), thread.get_id());
+}
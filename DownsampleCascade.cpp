@@ -0,0 +1,114 @@
+#include "DownsampleCascade.h"
+
+#include <algorithm>
+
+void ArcdpsExtension::DownsampleBucket::Merge(const DownsampleBucket& pOther) {
+	if (pOther.Count == 0) {
+		return;
+	}
+	if (Count == 0) {
+		*this = pOther;
+		return;
+	}
+
+	Begin = std::min(Begin, pOther.Begin);
+	End = std::max(End, pOther.End);
+	Min = std::min(Min, pOther.Min);
+	Max = std::max(Max, pOther.Max);
+	Sum += pOther.Sum;
+	Count += pOther.Count;
+}
+
+class ArcdpsExtension::DownsampleCascade::CascadeTier : public RingBuffer<DownsampleBucket> {
+public:
+	CascadeTier(size_t pCapacity, size_t pFactor, CascadeTier* pNext)
+		: RingBuffer(pCapacity),
+		  mFactor(pFactor),
+		  mNext(pNext) {
+		EnableOnEvict();
+	}
+
+	void ClearTier() {
+		Clear();
+		mPending = {};
+		mPendingBuckets = 0;
+	}
+
+	/**
+	 * Evicted buckets, that are not merged into the next tier yet.
+	 */
+	[[nodiscard]] const DownsampleBucket& Pending() const {
+		return mPending;
+	}
+
+protected:
+	void OnEvict(DownsampleBucket& pElement) override {
+		if (mNext == nullptr) {
+			return;
+		}
+
+		mPending.Merge(pElement);
+		if (++mPendingBuckets == mFactor) {
+			mNext->PushBack(mPending);
+			mPending = {};
+			mPendingBuckets = 0;
+		}
+	}
+
+private:
+	size_t mFactor;
+	CascadeTier* mNext;
+	DownsampleBucket mPending;
+	size_t mPendingBuckets = 0;
+};
+
+ArcdpsExtension::DownsampleCascade::DownsampleCascade(size_t pTierCapacity, size_t pTierCount, size_t pFactor) {
+	pTierCount = std::max<size_t>(pTierCount, 1);
+	pFactor = std::max<size_t>(pFactor, 2);
+	pTierCapacity = std::max<size_t>(pTierCapacity, 1);
+
+	// create from the last tier, so every tier knows its successor
+	mTiers.resize(pTierCount);
+	CascadeTier* next = nullptr;
+	for (size_t i = pTierCount; i-- > 0;) {
+		mTiers[i] = std::make_unique<CascadeTier>(pTierCapacity, pFactor, next);
+		next = mTiers[i].get();
+	}
+}
+
+ArcdpsExtension::DownsampleCascade::~DownsampleCascade() = default;
+ArcdpsExtension::DownsampleCascade::DownsampleCascade(DownsampleCascade&& pOther) noexcept = default;
+ArcdpsExtension::DownsampleCascade& ArcdpsExtension::DownsampleCascade::operator=(DownsampleCascade&& pOther) noexcept = default;
+
+void ArcdpsExtension::DownsampleCascade::Push(uint64_t pTime, double pValue) {
+	mTiers.front()->PushBack(DownsampleBucket{pTime, pTime, pValue, pValue, pValue, 1});
+}
+
+std::vector<ArcdpsExtension::DownsampleBucket> ArcdpsExtension::DownsampleCascade::Query(uint64_t pBegin, uint64_t pEnd) const {
+	std::vector<DownsampleBucket> res;
+	const auto add = [&res, pBegin, pEnd](const DownsampleBucket& pBucket) {
+		if (pBucket.Count > 0 && pBucket.End >= pBegin && pBucket.Begin <= pEnd) {
+			res.push_back(pBucket);
+		}
+	};
+
+	// oldest data is in the last tier, followed by the pending bucket of the tier before it, then that tier
+	for (size_t i = mTiers.size(); i-- > 0;) {
+		const CascadeTier& tier = *mTiers[i];
+		add(tier.Pending());
+		for (const DownsampleBucket& bucket : tier) {
+			add(bucket);
+		}
+	}
+	return res;
+}
+
+const ArcdpsExtension::RingBuffer<ArcdpsExtension::DownsampleBucket>& ArcdpsExtension::DownsampleCascade::Tier(size_t pTier) const {
+	return *mTiers.at(pTier);
+}
+
+void ArcdpsExtension::DownsampleCascade::Clear() {
+	for (const auto& tier : mTiers) {
+		tier->ClearTier();
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "SimpleRingBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ArcdpsExtension {
+	/**
+	 * Aggregate of one or more samples.
+	 */
+	struct DownsampleBucket {
+		uint64_t Begin = 0; // time of the first sample
+		uint64_t End = 0;   // time of the last sample
+		double Min = 0.;
+		double Max = 0.;
+		double Sum = 0.;
+		uint64_t Count = 0;
+
+		[[nodiscard]] double Mean() const {
+			return Count > 0 ? Sum / static_cast<double>(Count) : 0.;
+		}
+
+		void Merge(const DownsampleBucket& pOther);
+	};
+
+	/**
+	 * Fixed memory history of a value over a long time (e.g. DPS over a whole WvW session).
+	 * Tier 0 holds the latest samples in full resolution. When a bucket is pushed out of tier k,
+	 * `Factor` of them are merged into one bucket of tier k+1. Buckets pushed out of the last tier are lost.
+	 * So every tier covers `Factor` times the time span of the previous one, with the same memory.
+	 * <br>
+	 * The tiers never overlap in time, tier k+1 only holds data that is older than everything in tier k.
+	 */
+	class DownsampleCascade {
+	public:
+		/**
+		 * @param pTierCapacity Number of buckets per tier
+		 * @param pTierCount Number of tiers, at least 1
+		 * @param pFactor Number of buckets of tier k that are merged into one bucket of tier k+1, at least 2
+		 */
+		DownsampleCascade(size_t pTierCapacity, size_t pTierCount, size_t pFactor);
+		~DownsampleCascade();
+
+		DownsampleCascade(const DownsampleCascade& pOther) = delete;
+		DownsampleCascade(DownsampleCascade&& pOther) noexcept;
+		DownsampleCascade& operator=(const DownsampleCascade& pOther) = delete;
+		DownsampleCascade& operator=(DownsampleCascade&& pOther) noexcept;
+
+		void Push(uint64_t pTime, double pValue);
+
+		/**
+		 * All buckets that overlap with [`pBegin`, `pEnd`], oldest first.
+		 * Older parts of the range come from coarser tiers, so every part is in the best available resolution.
+		 * This includes the partial buckets, that are not full enough to be pushed into the next tier yet.
+		 */
+		[[nodiscard]] std::vector<DownsampleBucket> Query(uint64_t pBegin, uint64_t pEnd) const;
+
+		[[nodiscard]] const RingBuffer<DownsampleBucket>& Tier(size_t pTier) const;
+
+		[[nodiscard]] size_t TierCount() const {
+			return mTiers.size();
+		}
+
+		void Clear();
+
+	private:
+		class CascadeTier;
+
+		std::vector<std::unique_ptr<CascadeTier>> mTiers;
+	};
+} // namespace ArcdpsExtension
@@ -0,0 +1,85 @@
+#include "DownsampleCascade.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace ArcdpsExtension;
+
+TEST(DownsampleCascadeTests, FullResolution) {
+	DownsampleCascade cascade(4, 3, 2);
+	for (uint64_t i = 0; i < 4; ++i) {
+		cascade.Push(i * 10, static_cast<double>(i));
+	}
+
+	EXPECT_EQ(cascade.Tier(0).Size(), 4);
+	EXPECT_EQ(cascade.Tier(1).Size(), 0);
+
+	const auto buckets = cascade.Query(10, 20);
+	ASSERT_EQ(buckets.size(), 2);
+	EXPECT_EQ(buckets[0].Begin, 10);
+	EXPECT_EQ(buckets[1].Sum, 2.);
+}
+
+TEST(DownsampleCascadeTests, Cascade) {
+	DownsampleCascade cascade(4, 3, 2);
+	// tier 0 holds 4 samples, tier 1 holds 4*2, tier 2 gets the 8 oldest as 2 buckets of 4
+	for (uint64_t i = 0; i < 20; ++i) {
+		cascade.Push(i, static_cast<double>(i));
+	}
+
+	EXPECT_EQ(cascade.Tier(0).Size(), 4);
+	EXPECT_EQ(cascade.Tier(1).Size(), 4);
+	EXPECT_EQ(cascade.Tier(2).Size(), 2);
+
+	// tier 1 buckets are pairs of samples
+	const DownsampleBucket& bucket = cascade.Tier(1)[0];
+	EXPECT_EQ(bucket.Count, 2);
+	EXPECT_EQ(bucket.End - bucket.Begin, 1);
+	EXPECT_EQ(bucket.Min, static_cast<double>(bucket.Begin));
+	EXPECT_EQ(bucket.Max, static_cast<double>(bucket.End));
+	EXPECT_EQ(bucket.Mean(), (bucket.Min + bucket.Max) / 2.);
+
+	// tier 2 buckets are 4 samples
+	EXPECT_EQ(cascade.Tier(2)[0].Count, 4);
+	EXPECT_EQ(cascade.Tier(2)[0].Begin, 0);
+
+	// nothing is lost yet, every sample is in exactly one bucket, ordered by time
+	const auto buckets = cascade.Query(0, 100);
+	uint64_t count = 0;
+	double sum = 0.;
+	uint64_t lastEnd = 0;
+	for (size_t i = 0; i < buckets.size(); ++i) {
+		if (i > 0) {
+			EXPECT_GT(buckets[i].Begin, lastEnd);
+		}
+		lastEnd = buckets[i].End;
+		count += buckets[i].Count;
+		sum += buckets[i].Sum;
+	}
+	EXPECT_EQ(count, 20);
+	EXPECT_EQ(sum, 19. * 20. / 2.);
+
+	// recent range only uses the finest tier
+	const auto recent = cascade.Query(17, 19);
+	ASSERT_EQ(recent.size(), 3);
+	for (const auto& element : recent) {
+		EXPECT_EQ(element.Count, 1);
+	}
+}
+
+TEST(DownsampleCascadeTests, FixedMemory) {
+	DownsampleCascade cascade(8, 2, 4);
+	for (uint64_t i = 0; i < 10'000; ++i) {
+		cascade.Push(i, 1.);
+	}
+
+	EXPECT_EQ(cascade.Tier(0).Size(), 8);
+	EXPECT_EQ(cascade.Tier(1).Size(), 8);
+	// newest data is still complete
+	EXPECT_EQ(cascade.Query(0, 10'000).back().End, 9'999);
+
+	cascade.Clear();
+	EXPECT_EQ(cascade.Tier(0).Size(), 0);
+	EXPECT_TRUE(cascade.Query(0, 10'000).empty());
+}
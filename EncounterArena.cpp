@@ -0,0 +1,48 @@
+#include "EncounterArena.h"
+
+ArcdpsExtension::EncounterArena::EncounterArena(size_t pInitialBlockSize, std::pmr::memory_resource* pUpstream)
+	: mUpstream(pUpstream, mStats),
+	  mMonotonic(pInitialBlockSize, &mUpstream) {}
+
+void ArcdpsExtension::EncounterArena::Open() {
+	mMonotonic.release();
+	mStats = Stats();
+	mOpen = true;
+}
+
+void ArcdpsExtension::EncounterArena::Release() {
+	mMonotonic.release();
+}
+
+void ArcdpsExtension::EncounterArena::Close() {
+	mMonotonic.release();
+	mOpen = false;
+}
+
+void* ArcdpsExtension::EncounterArena::do_allocate(size_t pBytes, size_t pAlignment) {
+	++mStats.Allocations;
+	mStats.BytesAllocated += pBytes;
+	return mMonotonic.allocate(pBytes, pAlignment);
+}
+
+void ArcdpsExtension::EncounterArena::do_deallocate(void* /*pPtr*/, size_t /*pBytes*/, size_t /*pAlignment*/) {
+	// memory is only given back on `Release()`
+}
+
+bool ArcdpsExtension::EncounterArena::do_is_equal(const std::pmr::memory_resource& pOther) const noexcept {
+	return this == &pOther;
+}
+
+void* ArcdpsExtension::EncounterArena::CountingUpstream::do_allocate(size_t pBytes, size_t pAlignment) {
+	++mStats.UpstreamAllocations;
+	mStats.UpstreamBytes += pBytes;
+	return mUpstream->allocate(pBytes, pAlignment);
+}
+
+void ArcdpsExtension::EncounterArena::CountingUpstream::do_deallocate(void* pPtr, size_t pBytes, size_t pAlignment) {
+	mUpstream->deallocate(pPtr, pBytes, pAlignment);
+}
+
+bool ArcdpsExtension::EncounterArena::CountingUpstream::do_is_equal(const std::pmr::memory_resource& pOther) const noexcept {
+	return this == &pOther;
+}
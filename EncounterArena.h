@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace ArcdpsExtension {
+	/**
+	 * Memory resource for state that only lives as long as one encounter (per-agent stats, skill maps, timelines, ...).
+	 * Allocations are served bump-pointer style out of big blocks and deallocation is a no-op.
+	 * All memory is given back to the upstream resource at once with `Release()`.
+	 * <br>
+	 * `CombatEventHandler` opens its arena on `LogStart` and releases it after `LogEnd` and `StatReset` were called.
+	 * Containers that use this resource have to be destroyed or cleared in those callbacks, they are dangling afterwards.
+	 * <br>
+	 * Usage:
+	 * @code
+	 * void LogStart(...) override {
+	 * 	mAgentStats.emplace(mEncounterArena.Resource());
+	 * }
+	 * void LogEnd(...) override {
+	 * 	// publish results ...
+	 * 	mAgentStats.reset();
+	 * }
+	 * std::optional<std::pmr::unordered_map<uintptr_t, AgentStats>> mAgentStats;
+	 * @endcode
+	 *
+	 * This class is not thread-safe, only use it from the thread that calls the event callbacks.
+	 */
+	class EncounterArena final : public std::pmr::memory_resource {
+	public:
+		struct Stats {
+			size_t Allocations = 0;         // allocations served by the arena
+			size_t BytesAllocated = 0;      // bytes requested from the arena
+			size_t UpstreamAllocations = 0; // blocks requested from the upstream resource
+			size_t UpstreamBytes = 0;       // bytes requested from the upstream resource
+		};
+
+		/**
+		 * @param pInitialBlockSize Size of the first block requested from upstream, following blocks grow geometrically.
+		 * @param pUpstream Resource the blocks are requested from.
+		 */
+		explicit EncounterArena(size_t pInitialBlockSize = 64 * 1024, std::pmr::memory_resource* pUpstream = std::pmr::new_delete_resource());
+		~EncounterArena() override = default;
+
+		// delete copy and move
+		EncounterArena(const EncounterArena& pOther) = delete;
+		EncounterArena(EncounterArena&& pOther) noexcept = delete;
+		EncounterArena& operator=(const EncounterArena& pOther) = delete;
+		EncounterArena& operator=(EncounterArena&& pOther) noexcept = delete;
+
+		/**
+		 * Start a new encounter. Leftovers of a previous encounter (e.g. LogStart without LogEnd) are released.
+		 */
+		void Open();
+
+		/**
+		 * Give all memory back to upstream. The arena stays open, if it was open before.
+		 */
+		void Release();
+
+		/**
+		 * Give all memory back to upstream and end the encounter.
+		 */
+		void Close();
+
+		[[nodiscard]] bool IsOpen() const {
+			return mOpen;
+		}
+
+		[[nodiscard]] std::pmr::memory_resource* Resource() {
+			return this;
+		}
+
+		/**
+		 * Statistics since the last `Open()`.
+		 */
+		[[nodiscard]] const Stats& GetStats() const {
+			return mStats;
+		}
+
+	protected:
+		void* do_allocate(size_t pBytes, size_t pAlignment) override;
+		void do_deallocate(void* pPtr, size_t pBytes, size_t pAlignment) override;
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& pOther) const noexcept override;
+
+	private:
+		/**
+		 * Forwards to the real upstream and counts the blocks the monotonic resource requests.
+		 */
+		class CountingUpstream final : public std::pmr::memory_resource {
+		public:
+			CountingUpstream(std::pmr::memory_resource* pUpstream, Stats& pStats) : mUpstream(pUpstream), mStats(pStats) {}
+
+		protected:
+			void* do_allocate(size_t pBytes, size_t pAlignment) override;
+			void do_deallocate(void* pPtr, size_t pBytes, size_t pAlignment) override;
+			[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& pOther) const noexcept override;
+
+		private:
+			std::pmr::memory_resource* mUpstream;
+			Stats& mStats;
+		};
+
+		Stats mStats;
+		CountingUpstream mUpstream;
+		std::pmr::monotonic_buffer_resource mMonotonic;
+		bool mOpen = false;
+	};
+} // namespace ArcdpsExtension
@@ -0,0 +1,85 @@
+#include "EncounterArena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+using namespace ArcdpsExtension;
+
+namespace {
+	/**
+	 * Counts every allocation that reaches the global allocator.
+	 */
+	class CountingResource final : public std::pmr::memory_resource {
+	public:
+		size_t Allocations = 0;
+
+	protected:
+		void* do_allocate(size_t pBytes, size_t pAlignment) override {
+			++Allocations;
+			return std::pmr::new_delete_resource()->allocate(pBytes, pAlignment);
+		}
+		void do_deallocate(void* pPtr, size_t pBytes, size_t pAlignment) override {
+			std::pmr::new_delete_resource()->deallocate(pPtr, pBytes, pAlignment);
+		}
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& pOther) const noexcept override {
+			return this == &pOther;
+		}
+	};
+
+	/**
+	 * Builds the typical per-fight state: a map of agents with a timeline each.
+	 */
+	void SimulateFight(std::pmr::memory_resource* pResource) {
+		std::pmr::unordered_map<uintptr_t, std::pmr::vector<uint64_t>> timelines(pResource);
+		for (uint64_t time = 0; time < 2000; ++time) {
+			timelines[time % 50].push_back(time);
+		}
+	}
+} // namespace
+
+TEST(EncounterArenaTests, OpenReleaseClose) {
+	EncounterArena arena;
+	EXPECT_FALSE(arena.IsOpen());
+
+	arena.Open();
+	EXPECT_TRUE(arena.IsOpen());
+
+	std::pmr::vector<uint64_t> values(arena.Resource());
+	values.resize(100, 5);
+	EXPECT_EQ(arena.GetStats().Allocations, 1);
+	EXPECT_EQ(arena.GetStats().UpstreamAllocations, 1);
+	values = std::pmr::vector<uint64_t>(arena.Resource());
+
+	arena.Release();
+	EXPECT_TRUE(arena.IsOpen());
+
+	arena.Close();
+	EXPECT_FALSE(arena.IsOpen());
+
+	// Open resets the statistics
+	arena.Open();
+	EXPECT_EQ(arena.GetStats().Allocations, 0);
+	EXPECT_EQ(arena.GetStats().UpstreamAllocations, 0);
+}
+
+TEST(EncounterArenaTests, AllocationCountPerFight) {
+	CountingResource global;
+	SimulateFight(&global);
+
+	CountingResource upstream;
+	EncounterArena arena(64 * 1024, &upstream);
+	arena.Open();
+	SimulateFight(arena.Resource());
+	arena.Close();
+
+	// Every node, bucket array and vector growth hits the global allocator without the arena.
+	// With the arena those are served from a handful of blocks.
+	EXPECT_GT(global.Allocations, 300);
+	EXPECT_LT(upstream.Allocations, 10);
+	EXPECT_EQ(arena.GetStats().UpstreamAllocations, upstream.Allocations);
+	EXPECT_EQ(arena.GetStats().Allocations, global.Allocations);
+}
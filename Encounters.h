@@ -0,0 +1,256 @@
+#pragma once
+
+#include "MobIDs.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+
+namespace ArcdpsExtension {
+	enum class Encounter : uint8_t {
+		Unknown,
+		// Raid
+		ValeGuardian,
+		Gorseval,
+		Sabetha,
+		Slothasor,
+		BanditTrio,
+		Matthias,
+		Escort,
+		KeepConstruct,
+		Xera,
+		Cairn,
+		MursaatOverseer,
+		Samarog,
+		Deimos,
+		SoullessHorror,
+		RiverOfSouls,
+		StatueOfIce,
+		StatueOfDeath,
+		StatueOfDarkness,
+		Dhuum,
+		ConjuredAmalgamate,
+		TwinLargos,
+		Qadim,
+		Adina,
+		Sabir,
+		PeerlessQadim,
+		// Strike Missions
+		Freezie,
+		ShiverpeaksPass,
+		VoiceAndClaw,
+		FraenirOfJormag,
+		Boneskinner,
+		WhisperOfJormag,
+		ColdWar,
+		AetherbladeHideout,
+		XunlaiJadeJunkyard,
+		KainengOverlook,
+		HarvestTemple,
+		OldLionsCourt,
+		// Fractals
+		MAMA,
+		Siax,
+		Ensolyss,
+		Skorvald,
+		Artsariiv,
+		Arkk,
+		MaiTrin,
+		ShadowMinotaur,
+		BroodQueen,
+		TheVoice,
+		Ai,
+		// Golems
+		Golem,
+		// Open World
+		Mordremoth,
+		SooWon,
+
+		Count,
+	};
+
+	enum class EncounterCategory : uint8_t {
+		Unknown,
+		Raid,
+		Strike,
+		Fractal,
+		Golem,
+		OpenWorld,
+	};
+
+	/**
+	 * How a challenge mote can be detected for an encounter.
+	 */
+	enum class CmDetection : uint8_t {
+		None,      // there is no challenge mote
+		SpeciesId, // the challenge mote uses its own species id, `EncounterClassification::ChallengeMode` is set
+		BossHealth, // only detectable by the max health of the boss, which is not part of the realtime api
+	};
+
+	struct EncounterInfo {
+		Encounter Id = Encounter::Unknown;
+		EncounterCategory Category = EncounterCategory::Unknown;
+		uint8_t Wing = 0; // raid wing, 0 for everything else
+		CmDetection CmHint = CmDetection::None;
+		std::span<const TargetID> Npcs; // all species that can start a log of this encounter
+		std::string_view Name;
+	};
+
+	struct EncounterClassification {
+		Encounter Id = Encounter::Unknown;
+		bool ChallengeMode = false;
+
+		constexpr bool operator==(const EncounterClassification&) const = default;
+	};
+
+	/**
+	 * @param pSpeciesId Species ID as given by LogStart/LogNpcUpdate
+	 * @return The encounter the species belongs to, `Encounter::Unknown` if it is none.
+	 */
+	[[nodiscard]] constexpr EncounterClassification ClassifyEncounter(uintptr_t pSpeciesId);
+
+	/**
+	 * @return Metadata of the encounter (also valid for `Encounter::Unknown`).
+	 */
+	[[nodiscard]] constexpr const EncounterInfo& GetEncounterInfo(Encounter pEncounter);
+
+	namespace EncounterDetail {
+		template<TargetID... Ids>
+		inline constexpr std::array<TargetID, sizeof...(Ids)> NPCS = {Ids...};
+
+		// Species ids that are only used in the challenge mote
+		inline constexpr std::array CM_SPECIES = {
+				TargetID::EchoOfScarletBriarCM,
+				TargetID::MinisterLiCM,
+				TargetID::PrototypeVermilionCM,
+				TargetID::PrototypeArseniteCM,
+				TargetID::PrototypeIndigoCM,
+		};
+
+		using enum EncounterCategory;
+		using CM = CmDetection;
+		using T = TargetID;
+
+		// Order has to match `Encounter`
+		inline constexpr std::array<EncounterInfo, static_cast<size_t>(Encounter::Count)> ENCOUNTERS = {{
+				{Encounter::Unknown, Unknown, 0, CM::None, {}, "Unknown"},
+				// Raid
+				{Encounter::ValeGuardian, Raid, 1, CM::None, NPCS<T::ValeGuardian>, "Vale Guardian"},
+				{Encounter::Gorseval, Raid, 1, CM::None, NPCS<T::Gorseval>, "Gorseval"},
+				{Encounter::Sabetha, Raid, 1, CM::None, NPCS<T::Sabetha>, "Sabetha"},
+				{Encounter::Slothasor, Raid, 2, CM::None, NPCS<T::Slothasor>, "Slothasor"},
+				{Encounter::BanditTrio, Raid, 2, CM::None, NPCS<T::Berg, T::Zane, T::Narella>, "Bandit Trio"},
+				{Encounter::Matthias, Raid, 2, CM::None, NPCS<T::Matthias>, "Matthias"},
+				{Encounter::Escort, Raid, 3, CM::None, NPCS<T::Escort>, "Escort"},
+				{Encounter::KeepConstruct, Raid, 3, CM::BossHealth, NPCS<T::KeepConstruct>, "Keep Construct"},
+				{Encounter::Xera, Raid, 3, CM::None, NPCS<T::Xera>, "Xera"},
+				{Encounter::Cairn, Raid, 4, CM::BossHealth, NPCS<T::Cairn>, "Cairn"},
+				{Encounter::MursaatOverseer, Raid, 4, CM::BossHealth, NPCS<T::MursaatOverseer>, "Mursaat Overseer"},
+				{Encounter::Samarog, Raid, 4, CM::BossHealth, NPCS<T::Samarog>, "Samarog"},
+				{Encounter::Deimos, Raid, 4, CM::BossHealth, NPCS<T::Deimos>, "Deimos"},
+				{Encounter::SoullessHorror, Raid, 5, CM::BossHealth, NPCS<T::SoullessHorror>, "Soulless Horror"},
+				{Encounter::RiverOfSouls, Raid, 5, CM::None, NPCS<T::Desmina>, "River of Souls"},
+				{Encounter::StatueOfIce, Raid, 5, CM::None, NPCS<T::BrokenKing>, "Statue of Ice"},
+				{Encounter::StatueOfDeath, Raid, 5, CM::None, NPCS<T::SoulEater>, "Statue of Death"},
+				{Encounter::StatueOfDarkness, Raid, 5, CM::None, NPCS<T::EyeOfJudgement, T::EyeOfFate>, "Statue of Darkness"},
+				{Encounter::Dhuum, Raid, 5, CM::BossHealth, NPCS<T::Dhuum>, "Dhuum"},
+				{Encounter::ConjuredAmalgamate, Raid, 6, CM::BossHealth, NPCS<T::ConjuredAmalgamate, T::CARightArm, T::CALeftArm, T::ConjuredAmalgamate_CHINA, T::CARightArm_CHINA, T::CALeftArm_CHINA>, "Conjured Amalgamate"},
+				{Encounter::TwinLargos, Raid, 6, CM::BossHealth, NPCS<T::Nikare, T::Kenut>, "Twin Largos"},
+				{Encounter::Qadim, Raid, 6, CM::BossHealth, NPCS<T::Qadim>, "Qadim"},
+				{Encounter::Adina, Raid, 7, CM::BossHealth, NPCS<T::Adina>, "Cardinal Adina"},
+				{Encounter::Sabir, Raid, 7, CM::BossHealth, NPCS<T::Sabir>, "Cardinal Sabir"},
+				{Encounter::PeerlessQadim, Raid, 7, CM::BossHealth, NPCS<T::PeerlessQadim>, "Qadim the Peerless"},
+				// Strike Missions
+				{Encounter::Freezie, Strike, 0, CM::None, NPCS<T::Freezie>, "Freezie"},
+				{Encounter::ShiverpeaksPass, Strike, 0, CM::None, NPCS<T::IcebroodConstruct>, "Shiverpeaks Pass"},
+				{Encounter::VoiceAndClaw, Strike, 0, CM::None, NPCS<T::VoiceOfTheFallen, T::ClawOfTheFallen, T::VoiceAndClaw>, "Voice and Claw of the Fallen"},
+				{Encounter::FraenirOfJormag, Strike, 0, CM::None, NPCS<T::FraenirOfJormag, T::IcebroodConstructFraenir>, "Fraenir of Jormag"},
+				{Encounter::Boneskinner, Strike, 0, CM::None, NPCS<T::Boneskinner>, "Boneskinner"},
+				{Encounter::WhisperOfJormag, Strike, 0, CM::None, NPCS<T::WhisperOfJormag>, "Whisper of Jormag"},
+				{Encounter::ColdWar, Strike, 0, CM::None, NPCS<T::VariniaStormsounder>, "Cold War"},
+				{Encounter::AetherbladeHideout, Strike, 0, CM::SpeciesId, NPCS<T::MaiTrinStrike, T::EchoOfScarletBriarNM, T::EchoOfScarletBriarCM>, "Aetherblade Hideout"},
+				{Encounter::XunlaiJadeJunkyard, Strike, 0, CM::BossHealth, NPCS<T::Ankka>, "Xunlai Jade Junkyard"},
+				{Encounter::KainengOverlook, Strike, 0, CM::SpeciesId, NPCS<T::MinisterLi, T::MinisterLiCM>, "Kaineng Overlook"},
+				{Encounter::HarvestTemple, Strike, 0, CM::BossHealth, NPCS<T::GadgetTheDragonVoid1, T::GadgetTheDragonVoid2, T::VoidAmalgamate1>, "Harvest Temple"},
+				{Encounter::OldLionsCourt, Strike, 0, CM::SpeciesId, NPCS<T::PrototypeVermilion, T::PrototypeArsenite, T::PrototypeIndigo, T::PrototypeVermilionCM, T::PrototypeArseniteCM, T::PrototypeIndigoCM>, "Old Lion's Court"},
+				// Fractals
+				{Encounter::MAMA, Fractal, 0, CM::BossHealth, NPCS<T::MAMA>, "MAMA"},
+				{Encounter::Siax, Fractal, 0, CM::BossHealth, NPCS<T::Siax>, "Siax the Corrupted"},
+				{Encounter::Ensolyss, Fractal, 0, CM::BossHealth, NPCS<T::Ensolyss>, "Ensolyss of the Endless Torment"},
+				{Encounter::Skorvald, Fractal, 0, CM::BossHealth, NPCS<T::Skorvald>, "Skorvald"},
+				{Encounter::Artsariiv, Fractal, 0, CM::BossHealth, NPCS<T::Artsariiv>, "Artsariiv"},
+				{Encounter::Arkk, Fractal, 0, CM::BossHealth, NPCS<T::Arkk>, "Arkk"},
+				{Encounter::MaiTrin, Fractal, 0, CM::None, NPCS<T::MaiTrinFract>, "Mai Trin"},
+				{Encounter::ShadowMinotaur, Fractal, 0, CM::None, NPCS<T::ShadowMinotaur>, "Shadow Minotaur"},
+				{Encounter::BroodQueen, Fractal, 0, CM::None, NPCS<T::BroodQueen>, "Brood Queen"},
+				{Encounter::TheVoice, Fractal, 0, CM::None, NPCS<T::TheVoice>, "The Voice"},
+				{Encounter::Ai, Fractal, 0, CM::BossHealth, NPCS<T::AiKeeperOfThePeak>, "Ai, Keeper of the Peak"},
+				// Golems
+				{Encounter::Golem, Golem, 0, CM::None, NPCS<T::MassiveGolem10M, T::MassiveGolem4M, T::MassiveGolem1M, T::VitalGolem, T::AvgGolem, T::StdGolem, T::LGolem, T::MedGolem, T::ConditionGolem, T::PowerGolem>, "Special Forces Training Area"},
+				// Open World
+				{Encounter::Mordremoth, OpenWorld, 0, CM::None, NPCS<T::Mordremoth>, "Mordremoth"},
+				{Encounter::SooWon, OpenWorld, 0, CM::None, NPCS<T::SooWonOW>, "Soo-Won"},
+		}};
+
+		struct SpeciesEntry {
+			int SpeciesId;
+			EncounterClassification Classification;
+		};
+
+		consteval size_t CountSpecies() {
+			size_t count = 0;
+			for (const auto& encounter : ENCOUNTERS) {
+				count += encounter.Npcs.size();
+			}
+			return count;
+		}
+
+		/**
+		 * All species of `ENCOUNTERS`, sorted by id. Generated at compile time, so there is no static initialization at load.
+		 */
+		inline constexpr auto SPECIES = [] {
+			std::array<SpeciesEntry, CountSpecies()> species{};
+			size_t i = 0;
+			for (const auto& encounter : ENCOUNTERS) {
+				for (TargetID npc : encounter.Npcs) {
+					species[i++] = {static_cast<int>(npc), {encounter.Id, std::ranges::find(CM_SPECIES, npc) != CM_SPECIES.end()}};
+				}
+			}
+			std::ranges::sort(species, {}, &SpeciesEntry::SpeciesId);
+			return species;
+		}();
+
+		static_assert(std::ranges::adjacent_find(SPECIES, {}, &SpeciesEntry::SpeciesId) == SPECIES.end(), "species is used in multiple encounters");
+		static_assert([] {
+			for (size_t i = 0; i < ENCOUNTERS.size(); ++i) {
+				if (static_cast<size_t>(ENCOUNTERS[i].Id) != i) return false;
+			}
+			return true;
+		}(),
+					  "ENCOUNTERS is not in the order of `Encounter`");
+	} // namespace EncounterDetail
+} // namespace ArcdpsExtension
+
+constexpr ArcdpsExtension::EncounterClassification ArcdpsExtension::ClassifyEncounter(uintptr_t pSpeciesId) {
+	using EncounterDetail::SPECIES;
+
+	if (pSpeciesId > static_cast<uintptr_t>(std::numeric_limits<int>::max())) {
+		return {};
+	}
+	const auto it = std::ranges::lower_bound(SPECIES, static_cast<int>(pSpeciesId), {}, &EncounterDetail::SpeciesEntry::SpeciesId);
+	if (it == SPECIES.end() || it->SpeciesId != static_cast<int>(pSpeciesId)) {
+		return {};
+	}
+	return it->Classification;
+}
+
+constexpr const ArcdpsExtension::EncounterInfo& ArcdpsExtension::GetEncounterInfo(Encounter pEncounter) {
+	if (pEncounter >= Encounter::Count) {
+		return EncounterDetail::ENCOUNTERS[0];
+	}
+	return EncounterDetail::ENCOUNTERS[static_cast<size_t>(pEncounter)];
+}
@@ -0,0 +1,54 @@
+#include "Encounters.h"
+#include "MobIDs.h"
+
+#include <gtest/gtest.h>
+
+using namespace ArcdpsExtension;
+
+// classification is available at compile time
+static_assert(ClassifyEncounter(static_cast<uintptr_t>(TargetID::ValeGuardian)).Id == Encounter::ValeGuardian);
+static_assert(GetEncounterInfo(Encounter::Dhuum).Wing == 5);
+
+TEST(EncountersTests, Classify) {
+	EXPECT_EQ(ClassifyEncounter(static_cast<uintptr_t>(TargetID::Sabetha)), (EncounterClassification{Encounter::Sabetha, false}));
+	EXPECT_EQ(ClassifyEncounter(static_cast<uintptr_t>(TargetID::Zane)).Id, Encounter::BanditTrio);
+	EXPECT_EQ(ClassifyEncounter(static_cast<uintptr_t>(TargetID::Kenut)).Id, Encounter::TwinLargos);
+	EXPECT_EQ(ClassifyEncounter(static_cast<uintptr_t>(TargetID::PowerGolem)).Id, Encounter::Golem);
+}
+
+TEST(EncountersTests, ClassifyUnknown) {
+	EXPECT_EQ(ClassifyEncounter(1).Id, Encounter::Unknown);
+	EXPECT_EQ(ClassifyEncounter(0).Id, Encounter::Unknown);
+	EXPECT_EQ(ClassifyEncounter(static_cast<uintptr_t>(TrashID::Seekers)).Id, Encounter::Unknown);
+	// values that do not fit into the species range
+	EXPECT_EQ(ClassifyEncounter(static_cast<uintptr_t>(UINT32_MAX) + static_cast<uintptr_t>(TargetID::Sabetha)).Id, Encounter::Unknown);
+}
+
+TEST(EncountersTests, ChallengeMode) {
+	EXPECT_FALSE(ClassifyEncounter(static_cast<uintptr_t>(TargetID::MinisterLi)).ChallengeMode);
+	EXPECT_TRUE(ClassifyEncounter(static_cast<uintptr_t>(TargetID::MinisterLiCM)).ChallengeMode);
+	EXPECT_EQ(ClassifyEncounter(static_cast<uintptr_t>(TargetID::MinisterLiCM)).Id, Encounter::KainengOverlook);
+	EXPECT_EQ(GetEncounterInfo(Encounter::KainengOverlook).CmHint, CmDetection::SpeciesId);
+	EXPECT_EQ(GetEncounterInfo(Encounter::ValeGuardian).CmHint, CmDetection::None);
+}
+
+TEST(EncountersTests, Info) {
+	const auto& info = GetEncounterInfo(Encounter::StatueOfDarkness);
+	EXPECT_EQ(info.Id, Encounter::StatueOfDarkness);
+	EXPECT_EQ(info.Category, EncounterCategory::Raid);
+	EXPECT_EQ(info.Wing, 5);
+	ASSERT_EQ(info.Npcs.size(), 2);
+	EXPECT_EQ(info.Npcs[0], TargetID::EyeOfJudgement);
+	EXPECT_EQ(info.Npcs[1], TargetID::EyeOfFate);
+
+	EXPECT_EQ(GetEncounterInfo(Encounter::Count).Id, Encounter::Unknown);
+}
+
+TEST(EncountersTests, EveryNpcClassifiesToItsEncounter) {
+	for (size_t i = 0; i < static_cast<size_t>(Encounter::Count); ++i) {
+		const auto& info = GetEncounterInfo(static_cast<Encounter>(i));
+		for (TargetID npc : info.Npcs) {
+			EXPECT_EQ(ClassifyEncounter(static_cast<uintptr_t>(npc)).Id, info.Id) << info.Name;
+		}
+	}
+}
@@ -0,0 +1,237 @@
+#include "HttpCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <system_error>
+#include <utility>
+
+namespace {
+	struct CacheControl {
+		bool NoStore = false;
+		bool NoCache = false;
+		std::optional<int64_t> MaxAge;
+	};
+
+	CacheControl parseCacheControl(std::string_view pValue) {
+		CacheControl result;
+		while (!pValue.empty()) {
+			size_t end = pValue.find(',');
+			std::string directive(pValue.substr(0, end));
+			pValue = end == std::string_view::npos ? std::string_view() : pValue.substr(end + 1);
+
+			std::erase_if(directive, [](unsigned char c) { return std::isspace(c); });
+			std::ranges::transform(directive, directive.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+			if (directive == "no-store") {
+				result.NoStore = true;
+			} else if (directive == "no-cache") {
+				result.NoCache = true;
+			} else if (directive.starts_with("max-age=")) {
+				int64_t maxAge = 0;
+				const char* begin = directive.data() + 8;
+				if (auto [ptr, ec] = std::from_chars(begin, directive.data() + directive.size(), maxAge); ec == std::errc()) {
+					result.MaxAge = maxAge;
+				}
+			}
+		}
+		return result;
+	}
+
+	const std::string* findHeader(const ArcdpsExtension::HttpCache::Headers& pHeaders, const std::string& pName) {
+		auto it = pHeaders.find(pName);
+		return it == pHeaders.end() ? nullptr : &it->second;
+	}
+} // namespace
+
+ArcdpsExtension::HttpCache::HttpCache(std::filesystem::path pDirectory) : mDirectory(std::move(pDirectory)) {
+	std::error_code error;
+	std::filesystem::create_directories(mDirectory, error);
+}
+
+std::optional<ArcdpsExtension::HttpCache::Entry> ArcdpsExtension::HttpCache::Lookup(std::string_view pUrl) const {
+	std::ifstream file(metaPath(pUrl));
+	if (!file) {
+		return std::nullopt;
+	}
+
+	const auto json = nlohmann::json::parse(file, nullptr, false);
+	if (json.is_discarded() || !json.is_object()) {
+		return std::nullopt;
+	}
+
+	Entry entry;
+	entry.Url = json.value("url", "");
+	// different URL with the same hash
+	if (entry.Url != pUrl) {
+		return std::nullopt;
+	}
+	entry.ETag = json.value("etag", "");
+	entry.LastModified = json.value("lastModified", "");
+	entry.Code = json.value("code", 0l);
+	entry.StoredAt = json.value("storedAt", int64_t{0});
+	entry.MaxAge = json.value("maxAge", int64_t{0});
+	return entry;
+}
+
+bool ArcdpsExtension::HttpCache::ReadBody(std::string_view pUrl, std::string& pBody) const {
+	std::ifstream file(bodyPath(pUrl), std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	pBody.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+bool ArcdpsExtension::HttpCache::CopyBody(std::string_view pUrl, const std::filesystem::path& pTarget) const {
+	std::error_code error;
+	return std::filesystem::copy_file(bodyPath(pUrl), pTarget, std::filesystem::copy_options::overwrite_existing, error);
+}
+
+bool ArcdpsExtension::HttpCache::Store(std::string_view pUrl, long pCode, const Headers& pHeaders, std::string_view pBody) {
+	auto entry = makeEntry(pUrl, pCode, pHeaders);
+	if (!entry) {
+		return false;
+	}
+
+	// write to a temporary file first, a crash never leaves a half written body behind
+	const auto body = bodyPath(pUrl);
+	auto temp = body;
+	temp += ".tmp";
+	{
+		std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+		if (!file.write(pBody.data(), static_cast<std::streamsize>(pBody.size()))) {
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temp, body, error);
+	if (error) {
+		return false;
+	}
+	return writeEntry(*entry);
+}
+
+bool ArcdpsExtension::HttpCache::StoreFile(std::string_view pUrl, long pCode, const Headers& pHeaders, const std::filesystem::path& pBodyFile) {
+	auto entry = makeEntry(pUrl, pCode, pHeaders);
+	if (!entry) {
+		return false;
+	}
+
+	const auto body = bodyPath(pUrl);
+	auto temp = body;
+	temp += ".tmp";
+	std::error_code error;
+	std::filesystem::copy_file(pBodyFile, temp, std::filesystem::copy_options::overwrite_existing, error);
+	if (error) {
+		return false;
+	}
+	std::filesystem::rename(temp, body, error);
+	if (error) {
+		return false;
+	}
+	return writeEntry(*entry);
+}
+
+void ArcdpsExtension::HttpCache::Refresh(Entry& pEntry, const Headers& pHeaders) {
+	applyHeaders(pEntry, pHeaders);
+	pEntry.StoredAt = Now();
+	writeEntry(pEntry);
+}
+
+void ArcdpsExtension::HttpCache::Remove(std::string_view pUrl) {
+	std::error_code error;
+	std::filesystem::remove(metaPath(pUrl), error);
+	std::filesystem::remove(bodyPath(pUrl), error);
+}
+
+void ArcdpsExtension::HttpCache::Clear() {
+	std::error_code error;
+	for (const auto& file : std::filesystem::directory_iterator(mDirectory, error)) {
+		const auto extension = file.path().extension();
+		if (extension == ".json" || extension == ".body" || extension == ".tmp") {
+			std::filesystem::remove(file.path(), error);
+		}
+	}
+}
+
+uint64_t ArcdpsExtension::HttpCache::Hash(std::string_view pUrl) {
+	// FNV-1a, 64 bit
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : pUrl) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+int64_t ArcdpsExtension::HttpCache::Now() {
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::filesystem::path ArcdpsExtension::HttpCache::metaPath(std::string_view pUrl) const {
+	return mDirectory / std::format("{:016x}.json", Hash(pUrl));
+}
+
+std::filesystem::path ArcdpsExtension::HttpCache::bodyPath(std::string_view pUrl) const {
+	return mDirectory / std::format("{:016x}.body", Hash(pUrl));
+}
+
+bool ArcdpsExtension::HttpCache::writeEntry(const Entry& pEntry) const {
+	nlohmann::json json{
+			{"url", pEntry.Url},
+			{"etag", pEntry.ETag},
+			{"lastModified", pEntry.LastModified},
+			{"code", pEntry.Code},
+			{"storedAt", pEntry.StoredAt},
+			{"maxAge", pEntry.MaxAge},
+	};
+
+	std::ofstream file(metaPath(pEntry.Url), std::ios::trunc);
+	file << json.dump();
+	return static_cast<bool>(file);
+}
+
+std::optional<ArcdpsExtension::HttpCache::Entry> ArcdpsExtension::HttpCache::makeEntry(std::string_view pUrl, long pCode, const Headers& pHeaders) {
+	if (pCode != 200) {
+		return std::nullopt;
+	}
+
+	CacheControl cacheControl;
+	if (const auto* value = findHeader(pHeaders, "cache-control")) {
+		cacheControl = parseCacheControl(*value);
+	}
+	if (cacheControl.NoStore) {
+		return std::nullopt;
+	}
+
+	Entry entry;
+	entry.Url = pUrl;
+	entry.Code = pCode;
+	entry.StoredAt = Now();
+	applyHeaders(entry, pHeaders);
+
+	// nothing to reuse it with
+	if (entry.MaxAge <= 0 && !entry.HasValidator()) {
+		return std::nullopt;
+	}
+	return entry;
+}
+
+void ArcdpsExtension::HttpCache::applyHeaders(Entry& pEntry, const Headers& pHeaders) {
+	if (const auto* value = findHeader(pHeaders, "etag")) {
+		pEntry.ETag = *value;
+	}
+	if (const auto* value = findHeader(pHeaders, "last-modified")) {
+		pEntry.LastModified = *value;
+	}
+	if (const auto* value = findHeader(pHeaders, "cache-control")) {
+		const auto cacheControl = parseCacheControl(*value);
+		pEntry.MaxAge = cacheControl.NoCache ? 0 : cacheControl.MaxAge.value_or(0);
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ArcdpsExtension {
+	/**
+	 * On-disk cache for HTTP responses, used by `SimpleNetworkStack`.
+	 * Every URL has two files in the cache directory, named by the FNV-1a hash of the URL:
+	 * `<hash>.json` with the metadata (URL, ETag, Last-Modified, max-age, ...) and `<hash>.body` with the body.
+	 * <br>
+	 * Only responses with status 200 are stored, and only if they can be used again:
+	 * they need a `Cache-Control: max-age` or a validator (`ETag`/`Last-Modified`) and must not be `no-store`.
+	 * Entries within their max-age are fresh and can be used without network access,
+	 * stale entries have to be revalidated with a conditional GET first.
+	 * <br>
+	 * Not thread-safe, all calls have to come from the same thread.
+	 */
+	class HttpCache {
+	public:
+		// response headers, names are lowercase
+		using Headers = std::map<std::string, std::string>;
+
+		struct Entry {
+			std::string Url;
+			std::string ETag;
+			std::string LastModified;
+			long Code = 0;
+			int64_t StoredAt = 0; // unix time in seconds
+			int64_t MaxAge = 0;   // in seconds
+
+			[[nodiscard]] bool Fresh(int64_t pNow) const {
+				return pNow >= StoredAt && pNow - StoredAt < MaxAge;
+			}
+
+			[[nodiscard]] bool HasValidator() const {
+				return !ETag.empty() || !LastModified.empty();
+			}
+		};
+
+		/**
+		 * @param pDirectory Directory for the cache files, it is created if it doesn't exist.
+		 */
+		explicit HttpCache(std::filesystem::path pDirectory);
+
+		/**
+		 * @return The entry of `pUrl`, fresh or stale, if there is one.
+		 */
+		[[nodiscard]] std::optional<Entry> Lookup(std::string_view pUrl) const;
+
+		/**
+		 * Read the cached body of `pUrl` into `pBody`.
+		 * @return `false` if there is no body.
+		 */
+		bool ReadBody(std::string_view pUrl, std::string& pBody) const;
+
+		/**
+		 * Copy the cached body of `pUrl` into the file `pTarget`.
+		 * @return `false` if there is no body or it cannot be copied.
+		 */
+		bool CopyBody(std::string_view pUrl, const std::filesystem::path& pTarget) const;
+
+		/**
+		 * Store a response, if it is cacheable.
+		 * @return `true` if the response was stored.
+		 */
+		bool Store(std::string_view pUrl, long pCode, const Headers& pHeaders, std::string_view pBody);
+
+		/**
+		 * Same as `Store`, with the body taken from the file `pBodyFile`.
+		 */
+		bool StoreFile(std::string_view pUrl, long pCode, const Headers& pHeaders, const std::filesystem::path& pBodyFile);
+
+		/**
+		 * Mark an entry as fresh again, after the server answered a conditional GET with 304.
+		 * Max-age and validators are updated from `pHeaders`, if they are set.
+		 */
+		void Refresh(Entry& pEntry, const Headers& pHeaders);
+
+		/**
+		 * Remove the entry of `pUrl`, e.g. when its body is lost.
+		 */
+		void Remove(std::string_view pUrl);
+
+		/**
+		 * Remove all entries.
+		 */
+		void Clear();
+
+		[[nodiscard]] const std::filesystem::path& Directory() const {
+			return mDirectory;
+		}
+
+		static uint64_t Hash(std::string_view pUrl);
+
+		/**
+		 * @return Current unix time in seconds.
+		 */
+		static int64_t Now();
+
+	private:
+		std::filesystem::path mDirectory;
+
+		[[nodiscard]] std::filesystem::path metaPath(std::string_view pUrl) const;
+		[[nodiscard]] std::filesystem::path bodyPath(std::string_view pUrl) const;
+		bool writeEntry(const Entry& pEntry) const;
+		static std::optional<Entry> makeEntry(std::string_view pUrl, long pCode, const Headers& pHeaders);
+		static void applyHeaders(Entry& pEntry, const Headers& pHeaders);
+	};
+} // namespace ArcdpsExtension
@@ -0,0 +1,109 @@
+#include "HttpCache.h"
+
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace ArcdpsExtension;
+
+class HttpCacheTests : public ::testing::Test {
+protected:
+	const std::filesystem::path mDirectory = std::filesystem::temp_directory_path() / "HttpCacheTests";
+
+	void SetUp() override {
+		std::filesystem::remove_all(mDirectory);
+	}
+
+	void TearDown() override {
+		std::filesystem::remove_all(mDirectory);
+	}
+};
+
+TEST_F(HttpCacheTests, StoreAndLookup) {
+	HttpCache cache(mDirectory);
+	ASSERT_TRUE(cache.Store("https://example.com/a", 200, {{"etag", "\"v1\""}, {"cache-control", "public, max-age=60"}}, "body"));
+
+	auto entry = cache.Lookup("https://example.com/a");
+	ASSERT_TRUE(entry.has_value());
+	EXPECT_EQ(entry->ETag, "\"v1\"");
+	EXPECT_EQ(entry->MaxAge, 60);
+	EXPECT_EQ(entry->Code, 200);
+	EXPECT_TRUE(entry->Fresh(HttpCache::Now()));
+	EXPECT_FALSE(entry->Fresh(HttpCache::Now() + 60));
+
+	std::string body;
+	ASSERT_TRUE(cache.ReadBody("https://example.com/a", body));
+	EXPECT_EQ(body, "body");
+
+	EXPECT_FALSE(cache.Lookup("https://example.com/b").has_value());
+}
+
+TEST_F(HttpCacheTests, SurvivesReopen) {
+	{
+		HttpCache cache(mDirectory);
+		ASSERT_TRUE(cache.Store("https://example.com/a", 200, {{"last-modified", "Wed, 21 Oct 2015 07:28:00 GMT"}}, "body"));
+	}
+
+	HttpCache cache(mDirectory);
+	auto entry = cache.Lookup("https://example.com/a");
+	ASSERT_TRUE(entry.has_value());
+	EXPECT_EQ(entry->LastModified, "Wed, 21 Oct 2015 07:28:00 GMT");
+	// no max-age, so it always has to be revalidated
+	EXPECT_FALSE(entry->Fresh(HttpCache::Now()));
+	EXPECT_TRUE(entry->HasValidator());
+}
+
+TEST_F(HttpCacheTests, NotCacheable) {
+	HttpCache cache(mDirectory);
+	EXPECT_FALSE(cache.Store("https://example.com/a", 200, {{"etag", "\"v1\""}, {"cache-control", "no-store"}}, "body"));
+	EXPECT_FALSE(cache.Store("https://example.com/b", 404, {{"etag", "\"v1\""}}, "body"));
+	// neither max-age nor validator
+	EXPECT_FALSE(cache.Store("https://example.com/c", 200, {}, "body"));
+	EXPECT_FALSE(cache.Lookup("https://example.com/a").has_value());
+}
+
+TEST_F(HttpCacheTests, NoCacheRevalidates) {
+	HttpCache cache(mDirectory);
+	ASSERT_TRUE(cache.Store("https://example.com/a", 200, {{"etag", "\"v1\""}, {"cache-control", "no-cache, max-age=60"}}, "body"));
+	auto entry = cache.Lookup("https://example.com/a");
+	ASSERT_TRUE(entry.has_value());
+	EXPECT_FALSE(entry->Fresh(HttpCache::Now()));
+}
+
+TEST_F(HttpCacheTests, Refresh) {
+	HttpCache cache(mDirectory);
+	ASSERT_TRUE(cache.Store("https://example.com/a", 200, {{"etag", "\"v1\""}}, "body"));
+	auto entry = cache.Lookup("https://example.com/a");
+	ASSERT_TRUE(entry.has_value());
+	ASSERT_FALSE(entry->Fresh(HttpCache::Now()));
+
+	cache.Refresh(*entry, {{"etag", "\"v2\""}, {"cache-control", "max-age=30"}});
+	entry = cache.Lookup("https://example.com/a");
+	ASSERT_TRUE(entry.has_value());
+	EXPECT_EQ(entry->ETag, "\"v2\"");
+	EXPECT_TRUE(entry->Fresh(HttpCache::Now()));
+}
+
+TEST_F(HttpCacheTests, Remove) {
+	HttpCache cache(mDirectory);
+	ASSERT_TRUE(cache.Store("https://example.com/a", 200, {{"etag", "\"v1\""}}, "body"));
+	ASSERT_TRUE(cache.Store("https://example.com/b", 200, {{"etag", "\"v1\""}}, "body"));
+	cache.Remove("https://example.com/a");
+	EXPECT_FALSE(cache.Lookup("https://example.com/a").has_value());
+	EXPECT_TRUE(cache.Lookup("https://example.com/b").has_value());
+}
+
+TEST_F(HttpCacheTests, Clear) {
+	HttpCache cache(mDirectory);
+	ASSERT_TRUE(cache.Store("https://example.com/a", 200, {{"etag", "\"v1\""}}, "body"));
+	cache.Clear();
+	EXPECT_FALSE(cache.Lookup("https://example.com/a").has_value());
+	std::string body;
+	EXPECT_FALSE(cache.ReadBody("https://example.com/a", body));
+}
+
+TEST_F(HttpCacheTests, Hash) {
+	// reference values of FNV-1a 64
+	EXPECT_EQ(HttpCache::Hash(""), 0xcbf29ce484222325ull);
+	EXPECT_EQ(HttpCache::Hash("a"), 0xaf63dc4c8601ec8cull);
+}
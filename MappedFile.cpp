@@ -0,0 +1,168 @@
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+ArcdpsExtension::MappedFile::MappedFile(const std::filesystem::path& pPath, size_t pSize) : mSize(pSize) {
+	HANDLE file = CreateFileW(pPath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error(std::format("Failed to open '{}': {}", pPath.string(), GetLastError()));
+	}
+	mFile = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		const auto error = GetLastError();
+		close();
+		throw std::runtime_error(std::format("Failed to get size of '{}': {}", pPath.string(), error));
+	}
+	if (static_cast<size_t>(size.QuadPart) != pSize) {
+		mResized = true;
+		// a mapping can only grow the file, so shrink it first
+		LARGE_INTEGER newSize;
+		newSize.QuadPart = static_cast<LONGLONG>(pSize);
+		if (!SetFilePointerEx(file, newSize, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+			const auto error = GetLastError();
+			close();
+			throw std::runtime_error(std::format("Failed to resize '{}': {}", pPath.string(), error));
+		}
+	}
+
+	const auto size64 = static_cast<uint64_t>(pSize);
+	mMapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), nullptr);
+	if (mMapping == nullptr) {
+		const auto error = GetLastError();
+		close();
+		throw std::runtime_error(std::format("Failed to map '{}': {}", pPath.string(), error));
+	}
+
+	mData = static_cast<std::byte*>(MapViewOfFile(mMapping, FILE_MAP_ALL_ACCESS, 0, 0, pSize));
+	if (mData == nullptr) {
+		const auto error = GetLastError();
+		close();
+		throw std::runtime_error(std::format("Failed to map view of '{}': {}", pPath.string(), error));
+	}
+}
+
+void ArcdpsExtension::MappedFile::Flush() {
+	if (mData) {
+		FlushViewOfFile(mData, mSize);
+		FlushFileBuffers(mFile);
+	}
+}
+
+void ArcdpsExtension::MappedFile::close() {
+	if (mData) {
+		UnmapViewOfFile(mData);
+		mData = nullptr;
+	}
+	if (mMapping) {
+		CloseHandle(mMapping);
+		mMapping = nullptr;
+	}
+	if (mFile) {
+		CloseHandle(mFile);
+		mFile = nullptr;
+	}
+}
+
+ArcdpsExtension::MappedFile::MappedFile(MappedFile&& pOther) noexcept
+	: mData(std::exchange(pOther.mData, nullptr)),
+	  mSize(pOther.mSize),
+	  mResized(pOther.mResized),
+	  mFile(std::exchange(pOther.mFile, nullptr)),
+	  mMapping(std::exchange(pOther.mMapping, nullptr)) {}
+
+ArcdpsExtension::MappedFile& ArcdpsExtension::MappedFile::operator=(MappedFile&& pOther) noexcept {
+	if (this == &pOther)
+		return *this;
+	close();
+	mData = std::exchange(pOther.mData, nullptr);
+	mSize = pOther.mSize;
+	mResized = pOther.mResized;
+	mFile = std::exchange(pOther.mFile, nullptr);
+	mMapping = std::exchange(pOther.mMapping, nullptr);
+	return *this;
+}
+#else
+ArcdpsExtension::MappedFile::MappedFile(const std::filesystem::path& pPath, size_t pSize) : mSize(pSize) {
+	mFd = open(pPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (mFd < 0) {
+		throw std::runtime_error(std::format("Failed to open '{}': {}", pPath.string(), errno));
+	}
+
+	struct stat info {};
+	if (fstat(mFd, &info) != 0) {
+		const int error = errno;
+		close();
+		throw std::runtime_error(std::format("Failed to get size of '{}': {}", pPath.string(), error));
+	}
+	if (static_cast<size_t>(info.st_size) != pSize) {
+		mResized = true;
+		if (ftruncate(mFd, static_cast<off_t>(pSize)) != 0) {
+			const int error = errno;
+			close();
+			throw std::runtime_error(std::format("Failed to resize '{}': {}", pPath.string(), error));
+		}
+	}
+
+	void* data = mmap(nullptr, pSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+	if (data == MAP_FAILED) {
+		const int error = errno;
+		close();
+		throw std::runtime_error(std::format("Failed to map '{}': {}", pPath.string(), error));
+	}
+	mData = static_cast<std::byte*>(data);
+}
+
+void ArcdpsExtension::MappedFile::Flush() {
+	if (mData) {
+		msync(mData, mSize, MS_SYNC);
+	}
+}
+
+void ArcdpsExtension::MappedFile::close() {
+	if (mData) {
+		munmap(mData, mSize);
+		mData = nullptr;
+	}
+	if (mFd >= 0) {
+		::close(mFd);
+		mFd = -1;
+	}
+}
+
+ArcdpsExtension::MappedFile::MappedFile(MappedFile&& pOther) noexcept
+	: mData(std::exchange(pOther.mData, nullptr)),
+	  mSize(pOther.mSize),
+	  mResized(pOther.mResized),
+	  mFd(std::exchange(pOther.mFd, -1)) {}
+
+ArcdpsExtension::MappedFile& ArcdpsExtension::MappedFile::operator=(MappedFile&& pOther) noexcept {
+	if (this == &pOther)
+		return *this;
+	close();
+	mData = std::exchange(pOther.mData, nullptr);
+	mSize = pOther.mSize;
+	mResized = pOther.mResized;
+	mFd = std::exchange(pOther.mFd, -1);
+	return *this;
+}
+#endif
+
+ArcdpsExtension::MappedFile::~MappedFile() {
+	close();
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace ArcdpsExtension {
+	/**
+	 * Read/write memory mapping of a whole file, shared with the file on disk.
+	 * Writes to `Data()` end up in the file, even when the process crashes afterward (the OS writes back the pages).
+	 * Uses `CreateFileMapping` on Windows and `mmap` everywhere else.
+	 */
+	class MappedFile {
+	public:
+		/**
+		 * Open or create the file and map it. The file is resized to `pSize`, if it has a different size.
+		 * @throws std::runtime_error if the file cannot be opened, resized or mapped.
+		 */
+		MappedFile(const std::filesystem::path& pPath, size_t pSize);
+		~MappedFile();
+
+		MappedFile(const MappedFile& pOther) = delete;
+		MappedFile(MappedFile&& pOther) noexcept;
+		MappedFile& operator=(const MappedFile& pOther) = delete;
+		MappedFile& operator=(MappedFile&& pOther) noexcept;
+
+		[[nodiscard]] std::byte* Data() {
+			return mData;
+		}
+		[[nodiscard]] const std::byte* Data() const {
+			return mData;
+		}
+		[[nodiscard]] size_t Size() const {
+			return mSize;
+		}
+
+		/**
+		 * @return `true` if the file did not exist or had a different size, the content is undefined then.
+		 */
+		[[nodiscard]] bool Resized() const {
+			return mResized;
+		}
+
+		/**
+		 * Write the mapped pages to disk. Not needed to survive a crash of the process, only to survive a crash of the OS.
+		 */
+		void Flush();
+
+	private:
+		std::byte* mData = nullptr;
+		size_t mSize = 0;
+		bool mResized = false;
+#ifdef _WIN32
+		void* mFile = nullptr;
+		void* mMapping = nullptr;
+#else
+		int mFd = -1;
+#endif
+
+		void close();
+	};
+} // namespace ArcdpsExtension
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "SimpleRingBuffer.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+
+namespace ArcdpsExtension {
+	/**
+	 * `RingBuffer` stored in a memory mapped file, so the latest history survives a crash of the game
+	 * and is available again right away on the next start, without any parsing.
+	 * Only for trivially copyable types, they are stored as they are in memory.
+	 * <br>
+	 * The file starts with a small header (commit word, generation, ...), followed by the elements.
+	 * If the file does not match (other type size or capacity, or broken), it is reset.
+	 * Every push writes the element first and then publishes it with a single release store of the commit word,
+	 * that holds the number of pushes (head and size are derived from it). The file has one spare slot more than the capacity,
+	 * a push always writes into the slot that is not visible, and never into a committed element.
+	 * So after a crash the last element is either complete or not there, and all older elements are untouched.
+	 * <br>
+	 * Usage:
+	 * @code
+	 * MappedRingBuffer<cbtevent> history(addonDir / "history.bin", 4096);
+	 * if (history.Restored()) {
+	 * 	// events of the last session are still in `history`
+	 * }
+	 * history.PushBack(*pEvent);
+	 * @endcode
+	 *
+	 * @tparam T The type that this buffer holds.
+	 */
+	template<typename T>
+	class MappedRingBuffer {
+		static_assert(std::is_trivially_copyable_v<T>, "MappedRingBuffer can only store trivially copyable types");
+
+	public:
+		using iterator = RingBufferIndexIterator<MappedRingBuffer, T>;
+		using const_iterator = RingBufferIndexIterator<const MappedRingBuffer, const T>;
+
+		static constexpr uint32_t Magic = 0x52444541; // "AEDR"
+		static constexpr uint32_t Version = 3;
+
+		struct Header {
+			uint32_t Magic;
+			uint32_t Version;
+			uint32_t ElementSize;
+			uint32_t ElementAlign;
+			uint64_t Capacity; // without the spare slot
+			// pushes since the last `Clear()` in the low 56 bits, a check byte of them in the high 8 bits
+			uint64_t Commit;
+			uint64_t Generation; // increased every time the file is opened
+		};
+
+		/**
+		 * @throws std::runtime_error if the file cannot be opened or mapped.
+		 */
+		MappedRingBuffer(const std::filesystem::path& pPath, size_t pCapacity)
+			: mFile(pPath, DataOffset + ((pCapacity == 0 ? 1 : pCapacity) + 1) * sizeof(T)) {
+			mHeader = reinterpret_cast<Header*>(mFile.Data());
+			mData = reinterpret_cast<T*>(mFile.Data() + DataOffset);
+			const uint64_t capacity = pCapacity == 0 ? 1 : pCapacity;
+
+			mRestored = !mFile.Resized() && valid(capacity);
+			if (!mRestored) {
+				Header header{Magic, Version, sizeof(T), alignof(T), capacity, commitWord(0), 0};
+				std::memcpy(mHeader, &header, sizeof(Header));
+			}
+			++mHeader->Generation;
+
+			// head and size are kept outside the file as well, so reads don't have to divide
+			mCapacity = capacity;
+			mSlots = capacity + 1;
+			mPushes = commit().load(std::memory_order_acquire) & CountMask;
+			mHead = mPushes % mSlots;
+			mSize = std::min(mPushes, mCapacity);
+		}
+
+		MappedRingBuffer(const MappedRingBuffer& pOther) = delete;
+		MappedRingBuffer(MappedRingBuffer&& pOther) noexcept = default;
+		MappedRingBuffer& operator=(const MappedRingBuffer& pOther) = delete;
+		MappedRingBuffer& operator=(MappedRingBuffer&& pOther) noexcept = default;
+
+		void PushBack(const T& pElement) {
+			// `mHead` is the spare slot, the oldest element stays intact until the commit
+			std::memcpy(mData + mHead, &pElement, sizeof(T));
+			if (++mHead == mSlots) mHead = 0;
+			if (mSize < mCapacity) ++mSize;
+			// the element is written before it becomes visible
+			mPushes = (mPushes + 1) & CountMask;
+			commit().store(commitWord(mPushes), std::memory_order_release);
+		}
+
+		[[nodiscard]] T& Back() { return mData[mHead == 0 ? mSlots - 1 : mHead - 1]; }
+		[[nodiscard]] const T& Back() const { return mData[mHead == 0 ? mSlots - 1 : mHead - 1]; }
+
+		void Clear() {
+			mPushes = mHead = mSize = 0;
+			commit().store(commitWord(0), std::memory_order_release);
+		}
+
+		[[nodiscard]] size_t Size() const { return mSize; }
+		[[nodiscard]] size_t Capacity() const { return mCapacity; }
+
+		/**
+		 * @return `true` if the content of the file was taken over from an earlier run.
+		 */
+		[[nodiscard]] bool Restored() const { return mRestored; }
+
+		/**
+		 * @return How often the file was opened, also counting this time.
+		 */
+		[[nodiscard]] uint64_t Generation() const { return mHeader->Generation; }
+
+		/**
+		 * See `MappedFile::Flush()`.
+		 */
+		void Flush() { mFile.Flush(); }
+
+		/**
+		 * Same as `RingBuffer::Segments()`.
+		 */
+		std::array<std::span<T>, 2> Segments() {
+			const size_t start = index(0);
+			const size_t first = std::min<size_t>(mSize, mSlots - start);
+			return {std::span<T>(mData + start, first), std::span<T>(mData, mSize - first)};
+		}
+
+		std::array<std::span<const T>, 2> Segments() const {
+			const size_t start = index(0);
+			const size_t first = std::min<size_t>(mSize, mSlots - start);
+			return {std::span<const T>(mData + start, first), std::span<const T>(mData, mSize - first)};
+		}
+
+		const T& operator[](size_t pNum) const { return mData[index(pNum)]; }
+		T& operator[](size_t pNum) { return mData[index(pNum)]; }
+
+		iterator begin() { return iterator(this, 0); }
+		iterator end() { return iterator(this, Size()); }
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, Size()); }
+
+	private:
+		static constexpr size_t DataOffset = (sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+		static constexpr uint64_t CountMask = (uint64_t{1} << 56) - 1;
+		static_assert(offsetof(Header, Commit) % std::atomic_ref<uint64_t>::required_alignment == 0);
+
+		MappedFile mFile;
+		Header* mHeader = nullptr;
+		T* mData = nullptr;
+		bool mRestored = false;
+		uint64_t mCapacity = 0;
+		uint64_t mSlots = 0; // capacity and the spare slot
+		uint64_t mPushes = 0;
+		uint64_t mHead = 0; // position of the next write
+		uint64_t mSize = 0;
+
+		[[nodiscard]] std::atomic_ref<uint64_t> commit() const {
+			return std::atomic_ref<uint64_t>(mHeader->Commit);
+		}
+
+		[[nodiscard]] static uint64_t checkByte(uint64_t pCount) {
+			// xor of all bytes of the count, with a fixed pattern, so an all zero word is invalid
+			uint64_t check = 0xA5;
+			for (int shift = 0; shift < 56; shift += 8) {
+				check ^= (pCount >> shift) & 0xFF;
+			}
+			return check;
+		}
+
+		[[nodiscard]] static uint64_t commitWord(uint64_t pCount) {
+			return (checkByte(pCount) << 56) | pCount;
+		}
+
+		[[nodiscard]] bool valid(uint64_t pCapacity) const {
+			const Header& header = *mHeader;
+			if (header.Magic != Magic || header.Version != Version || header.ElementSize != sizeof(T) || header.ElementAlign != alignof(T)
+				|| header.Capacity != pCapacity) {
+				return false;
+			}
+			const uint64_t word = commit().load(std::memory_order_acquire);
+			return word == commitWord(word & CountMask);
+		}
+
+		[[nodiscard]] size_t index(size_t pNum) const {
+			// Size < Slots, so a single wrap is enough in both directions
+			size_t res = mHead + mSlots - mSize + pNum;
+			if (res >= mSlots) res -= mSlots;
+			return res;
+		}
+	};
+} // namespace ArcdpsExtension
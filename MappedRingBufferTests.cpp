@@ -0,0 +1,124 @@
+#include "MappedRingBuffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace ArcdpsExtension;
+
+class MappedRingBufferTests : public ::testing::Test {
+protected:
+	std::filesystem::path mPath = std::filesystem::temp_directory_path() / "ArcdpsExtensionMappedRingBufferTests.bin";
+
+	void SetUp() override {
+		std::filesystem::remove(mPath);
+	}
+
+	void TearDown() override {
+		std::filesystem::remove(mPath);
+	}
+};
+
+TEST_F(MappedRingBufferTests, PushBackTest) {
+	MappedRingBuffer<uint64_t> buffer(mPath, 4);
+	EXPECT_FALSE(buffer.Restored());
+	EXPECT_EQ(buffer.Generation(), 1);
+
+	for (uint64_t i = 1; i < 4; ++i) {
+		buffer.PushBack(i);
+		EXPECT_EQ(buffer.Back(), i);
+	}
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{1, 2, 3}));
+
+	for (uint64_t i = 4; i < 8; ++i) {
+		buffer.PushBack(i);
+	}
+	EXPECT_EQ(buffer.Size(), 4);
+	EXPECT_EQ(buffer[0], 4);
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{4, 5, 6, 7}));
+
+	// 7 pushes in 4 + 1 spare slots, the oldest element is in slot 3
+	const auto segments = std::as_const(buffer).Segments();
+	EXPECT_TRUE(std::ranges::equal(segments[0], std::vector<uint64_t>{4, 5}));
+	EXPECT_TRUE(std::ranges::equal(segments[1], std::vector<uint64_t>{6, 7}));
+
+	buffer.Clear();
+	EXPECT_EQ(buffer.Size(), 0);
+}
+
+TEST_F(MappedRingBufferTests, ReopenTest) {
+	{
+		MappedRingBuffer<uint64_t> buffer(mPath, 4);
+		for (uint64_t i = 1; i < 7; ++i) {
+			buffer.PushBack(i);
+		}
+	}
+
+	{
+		MappedRingBuffer<uint64_t> buffer(mPath, 4);
+		EXPECT_TRUE(buffer.Restored());
+		EXPECT_EQ(buffer.Generation(), 2);
+		EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{3, 4, 5, 6}));
+		buffer.PushBack(7);
+	}
+
+	// other capacity resets the content
+	{
+		MappedRingBuffer<uint64_t> buffer(mPath, 8);
+		EXPECT_FALSE(buffer.Restored());
+		EXPECT_EQ(buffer.Size(), 0);
+	}
+
+	// other type resets the content
+	{
+		MappedRingBuffer<uint32_t> buffer(mPath, 16);
+		EXPECT_FALSE(buffer.Restored());
+		EXPECT_EQ(buffer.Size(), 0);
+	}
+}
+
+TEST_F(MappedRingBufferTests, BrokenHeaderTest) {
+	{
+		MappedRingBuffer<uint64_t> buffer(mPath, 4);
+		buffer.PushBack(1);
+	}
+	{
+		// corrupt the commit word
+		MappedFile file(mPath, std::filesystem::file_size(mPath));
+		reinterpret_cast<MappedRingBuffer<uint64_t>::Header*>(file.Data())->Commit ^= 0x100;
+	}
+
+	MappedRingBuffer<uint64_t> buffer(mPath, 4);
+	EXPECT_FALSE(buffer.Restored());
+	EXPECT_EQ(buffer.Size(), 0);
+}
+
+TEST_F(MappedRingBufferTests, TornWriteTest) {
+	{
+		MappedRingBuffer<uint64_t> buffer(mPath, 4);
+		for (uint64_t i = 1; i < 7; ++i) {
+			buffer.PushBack(i);
+		}
+	}
+	{
+		// a crash during the next push, the element is half written but not committed.
+		// 6 pushes in 5 slots, the next one goes to slot 1
+		MappedFile file(mPath, std::filesystem::file_size(mPath));
+		auto* data = reinterpret_cast<uint64_t*>(file.Data() + sizeof(MappedRingBuffer<uint64_t>::Header));
+		data[1] = 0xFFFFFFFF00000000;
+	}
+
+	MappedRingBuffer<uint64_t> buffer(mPath, 4);
+	EXPECT_TRUE(buffer.Restored());
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{3, 4, 5, 6}));
+	buffer.PushBack(7);
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{4, 5, 6, 7}));
+}
+
+TEST_F(MappedRingBufferTests, OpenFailureTest) {
+	EXPECT_THROW(MappedRingBuffer<uint64_t>(mPath / "missing_dir" / "file.bin", 4), std::runtime_error);
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "SpscRingBuffer.h"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+
+namespace ArcdpsExtension {
+	/**
+	 * Bounded lock-free queue for any number of producer and consumer threads (Dmitry Vyukov's bounded MPMC queue).
+	 * Every slot has a sequence number, that tells if it is free to write or ready to read for the current round.
+	 * Producers and consumers only compete on their own index with a single CAS, they never block each other.
+	 * Meant as replacement for the `std::queue` + `std::mutex` + `std::condition_variable_any` job queues.
+	 * <br>
+	 * `TryPush`/`TryPop` fail right away, if the queue is full/empty.
+	 * `Push`/`Pop` wait on the slot (`std::atomic::wait`) until they can continue.
+	 * The capacity is rounded up to the next power of two.
+	 *
+	 * @tparam T The type that this queue holds.
+	 */
+	template<typename T, typename Allocator = std::allocator<T>>
+	class MpmcQueue {
+	public:
+		explicit MpmcQueue(size_t pCapacity)
+			: mMask(std::bit_ceil(pCapacity < 2 ? size_t{2} : pCapacity) - 1) {
+			mCells = CellAllocator(mAlloc).allocate(mMask + 1);
+			for (size_t i = 0; i <= mMask; ++i) {
+				new (&mCells[i]) Cell();
+				mCells[i].Sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		~MpmcQueue() {
+			const size_t enqueue = mEnqueuePos.Value.load(std::memory_order_acquire);
+			for (size_t pos = mDequeuePos.Value.load(std::memory_order_acquire); pos != enqueue; ++pos) {
+				mCells[pos & mMask].Element()->~T();
+			}
+			for (size_t i = 0; i <= mMask; ++i) {
+				mCells[i].~Cell();
+			}
+			CellAllocator(mAlloc).deallocate(mCells, mMask + 1);
+		}
+
+		// delete copy and move, the atomics cannot be shared
+		MpmcQueue(const MpmcQueue& pOther) = delete;
+		MpmcQueue(MpmcQueue&& pOther) noexcept = delete;
+		MpmcQueue& operator=(const MpmcQueue& pOther) = delete;
+		MpmcQueue& operator=(MpmcQueue&& pOther) noexcept = delete;
+
+		/**
+		 * @return `false` if the queue is full, the element is not added then.
+		 */
+		bool TryPush(const T& pElement) { return emplace<false>(pElement); }
+		bool TryPush(T&& pElement) { return emplace<false>(std::move(pElement)); }
+
+		template<typename... Args>
+		bool TryEmplace(Args&&... args) {
+			return emplace<false>(std::forward<Args>(args)...);
+		}
+
+		/**
+		 * Wait until there is space in the queue.
+		 */
+		void Push(const T& pElement) { emplace<true>(pElement); }
+		void Push(T&& pElement) { emplace<true>(std::move(pElement)); }
+
+		template<typename... Args>
+		void Emplace(Args&&... args) {
+			emplace<true>(std::forward<Args>(args)...);
+		}
+
+		/**
+		 * Move the oldest element into `pElement`.
+		 * @return `false` if the queue is empty.
+		 */
+		bool TryPop(T& pElement) { return pop<false>(pElement); }
+
+		/**
+		 * Wait until there is an element in the queue and move it into `pElement`.
+		 */
+		void Pop(T& pElement) { pop<true>(pElement); }
+
+		/**
+		 * Push elements in order until the queue is full.
+		 * @return The number of pushed elements, the first ones of `pElements`.
+		 */
+		size_t TryPushBatch(std::span<const T> pElements) {
+			size_t count = 0;
+			while (count < pElements.size() && emplace<false>(pElements[count])) {
+				++count;
+			}
+			return count;
+		}
+
+		/**
+		 * Pop elements until the queue is empty or `pOut` is full.
+		 * Other consumers can pop at the same time, so the elements are not necessarily consecutive.
+		 * @return The number of elements written to the front of `pOut`.
+		 */
+		size_t TryPopBatch(std::span<T> pOut) {
+			size_t count = 0;
+			while (count < pOut.size() && pop<false>(pOut[count])) {
+				++count;
+			}
+			return count;
+		}
+
+		/**
+		 * Only a snapshot, other threads can change it any time.
+		 */
+		[[nodiscard]] size_t Size() const {
+			const size_t dequeue = mDequeuePos.Value.load(std::memory_order_acquire);
+			const size_t enqueue = mEnqueuePos.Value.load(std::memory_order_acquire);
+			return enqueue > dequeue ? enqueue - dequeue : 0;
+		}
+
+		[[nodiscard]] bool Empty() const {
+			return Size() == 0;
+		}
+
+		[[nodiscard]] size_t Capacity() const {
+			return mMask + 1;
+		}
+
+	private:
+		struct Cell {
+			std::atomic<size_t> Sequence;
+			alignas(T) std::byte Storage[sizeof(T)];
+
+			T* Element() { return std::launder(reinterpret_cast<T*>(Storage)); }
+		};
+
+		template<typename V>
+		struct alignas(CacheLineSize) Padded {
+			V Value{};
+		};
+
+		using CellAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Cell>;
+
+		const size_t mMask;
+		Cell* mCells = nullptr;
+		[[no_unique_address]] Allocator mAlloc;
+
+		Padded<std::atomic<size_t>> mEnqueuePos;
+		Padded<std::atomic<size_t>> mDequeuePos;
+		Padded<std::atomic<uint32_t>> mWaiters; // threads in `Push`/`Pop` that wait, so nobody else has to notify
+
+		void wait(Cell& pCell, size_t pSequence) {
+			mWaiters.Value.fetch_add(1, std::memory_order_seq_cst);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			pCell.Sequence.wait(pSequence, std::memory_order_acquire);
+			mWaiters.Value.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		void publish(Cell& pCell, size_t pSequence) {
+			pCell.Sequence.store(pSequence, std::memory_order_release);
+			// pairs with the fence in wait(), either the waiter sees the new sequence or we see the waiter
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (mWaiters.Value.load(std::memory_order_relaxed) > 0) {
+				pCell.Sequence.notify_all();
+			}
+		}
+
+		template<bool Blocking, typename... Args>
+		bool emplace(Args&&... args) {
+			size_t pos = mEnqueuePos.Value.load(std::memory_order_relaxed);
+			Cell* cell;
+			while (true) {
+				cell = &mCells[pos & mMask];
+				const size_t seq = cell->Sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+				if (diff == 0) {
+					// slot is free in this round, try to claim it
+					if (mEnqueuePos.Value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				} else if (diff < 0) {
+					// slot still holds the element of the last round, queue is full
+					if constexpr (!Blocking) {
+						return false;
+					}
+					wait(*cell, seq);
+					pos = mEnqueuePos.Value.load(std::memory_order_relaxed);
+				} else {
+					// another producer was faster
+					pos = mEnqueuePos.Value.load(std::memory_order_relaxed);
+				}
+			}
+
+			new (cell->Storage) T(std::forward<Args>(args)...);
+			publish(*cell, pos + 1);
+			return true;
+		}
+
+		template<bool Blocking>
+		bool pop(T& pElement) {
+			size_t pos = mDequeuePos.Value.load(std::memory_order_relaxed);
+			Cell* cell;
+			while (true) {
+				cell = &mCells[pos & mMask];
+				const size_t seq = cell->Sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+				if (diff == 0) {
+					// slot is filled in this round, try to claim it
+					if (mDequeuePos.Value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				} else if (diff < 0) {
+					// slot is not written yet, queue is empty
+					if constexpr (!Blocking) {
+						return false;
+					}
+					wait(*cell, seq);
+					pos = mDequeuePos.Value.load(std::memory_order_relaxed);
+				} else {
+					// another consumer was faster
+					pos = mDequeuePos.Value.load(std::memory_order_relaxed);
+				}
+			}
+
+			T* element = cell->Element();
+			pElement = std::move(*element);
+			element->~T();
+			// free the slot for the next round
+			publish(*cell, pos + mMask + 1);
+			return true;
+		}
+	};
+} // namespace ArcdpsExtension
@@ -0,0 +1,101 @@
+#include "MpmcQueue.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace ArcdpsExtension;
+
+namespace {
+	constexpr size_t Capacity = 1024;
+	constexpr uint64_t ItemsPerProducer = 1 << 16;
+
+	/**
+	 * The job queue as it is in `SimpleNetworkStack`, `IconLoader` and `EventSequencer`.
+	 */
+	class MutexQueue {
+	public:
+		explicit MutexQueue(size_t pCapacity) : mCapacity(pCapacity) {}
+
+		bool TryPush(uint64_t pElement) {
+			std::lock_guard guard(mMutex);
+			if (mQueue.size() == mCapacity) {
+				return false;
+			}
+			mQueue.push(pElement);
+			return true;
+		}
+
+		bool TryPop(uint64_t& pElement) {
+			std::lock_guard guard(mMutex);
+			if (mQueue.empty()) {
+				return false;
+			}
+			pElement = mQueue.front();
+			mQueue.pop();
+			return true;
+		}
+
+	private:
+		std::mutex mMutex;
+		size_t mCapacity;
+		std::queue<uint64_t> mQueue;
+	};
+
+	/**
+	 * `pState.range(0)` producers push into the queue, one consumer drains it.
+	 */
+	template<typename Queue>
+	void Producers(benchmark::State& pState) {
+		const auto producers = static_cast<size_t>(pState.range(0));
+		for (auto _ : pState) {
+			Queue queue(Capacity);
+			std::vector<std::jthread> threads;
+			for (size_t i = 0; i < producers; ++i) {
+				threads.emplace_back([&queue] {
+					for (uint64_t j = 0; j < ItemsPerProducer; ++j) {
+						while (!queue.TryPush(j)) {
+							std::this_thread::yield();
+						}
+					}
+				});
+			}
+
+			uint64_t sum = 0;
+			uint64_t value;
+			for (uint64_t received = 0; received < producers * ItemsPerProducer;) {
+				if (queue.TryPop(value)) {
+					sum += value;
+					++received;
+				} else {
+					std::this_thread::yield();
+				}
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		pState.SetItemsProcessed(pState.iterations() * static_cast<int64_t>(producers * ItemsPerProducer));
+	}
+
+	/**
+	 * Every benchmark thread pushes and pops on the same queue, so both ends are contended.
+	 */
+	template<typename Queue>
+	void PushPop(benchmark::State& pState) {
+		static Queue queue(Capacity);
+		uint64_t value = 0;
+		for (auto _ : pState) {
+			queue.TryPush(value);
+			queue.TryPop(value);
+			benchmark::DoNotOptimize(value);
+		}
+		pState.SetItemsProcessed(pState.iterations());
+	}
+} // namespace
+
+BENCHMARK(Producers<MpmcQueue<uint64_t>>)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK(Producers<MutexQueue>)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK(PushPop<MpmcQueue<uint64_t>>)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(PushPop<MutexQueue>)->ThreadRange(1, 16)->UseRealTime();
@@ -0,0 +1,112 @@
+#include "MpmcQueue.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ArcdpsExtension;
+
+TEST(MpmcQueueTests, TryPushPopTest) {
+	MpmcQueue<uint64_t> queue(3);
+	EXPECT_EQ(queue.Capacity(), 4);
+
+	uint64_t value = 0;
+	EXPECT_FALSE(queue.TryPop(value));
+
+	for (uint64_t i = 0; i < 4; ++i) {
+		EXPECT_TRUE(queue.TryPush(i));
+	}
+	EXPECT_FALSE(queue.TryPush(4));
+	EXPECT_EQ(queue.Size(), 4);
+
+	// wrap around multiple rounds
+	for (uint64_t i = 0; i < 20; ++i) {
+		ASSERT_TRUE(queue.TryPop(value));
+		EXPECT_EQ(value, i);
+		EXPECT_TRUE(queue.TryEmplace(i + 4));
+	}
+}
+
+TEST(MpmcQueueTests, BatchTest) {
+	MpmcQueue<uint64_t> queue(8);
+	const std::vector<uint64_t> values{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+	EXPECT_EQ(queue.TryPushBatch(values), 8);
+
+	std::array<uint64_t, 5> out{};
+	EXPECT_EQ(queue.TryPopBatch(out), 5);
+	EXPECT_EQ(out, (std::array<uint64_t, 5>{1, 2, 3, 4, 5}));
+	EXPECT_EQ(queue.TryPopBatch(out), 3);
+	EXPECT_EQ(out[2], 8);
+	EXPECT_TRUE(queue.Empty());
+}
+
+TEST(MpmcQueueTests, NonTrivialTest) {
+	auto counter = std::make_shared<int>(0);
+	{
+		MpmcQueue<std::shared_ptr<int>> queue(4);
+		queue.Push(counter);
+		queue.Emplace(counter);
+		EXPECT_EQ(counter.use_count(), 3);
+
+		std::shared_ptr<int> out;
+		queue.Pop(out);
+		out.reset();
+		EXPECT_EQ(counter.use_count(), 2);
+	}
+	// destructor releases the remaining elements
+	EXPECT_EQ(counter.use_count(), 1);
+
+	MpmcQueue<std::string> strings(2);
+	strings.Emplace(3, 'a');
+	std::string out;
+	strings.Pop(out);
+	EXPECT_EQ(out, "aaa");
+}
+
+TEST(MpmcQueueTests, ConcurrentTest) {
+	constexpr uint64_t perProducer = 20'000;
+	constexpr size_t producers = 4;
+	constexpr size_t consumers = 4;
+	MpmcQueue<uint64_t> queue(64);
+
+	std::atomic<uint64_t> sum = 0;
+	std::atomic<uint64_t> received = 0;
+	{
+		std::vector<std::jthread> threads;
+		for (size_t p = 0; p < producers; ++p) {
+			threads.emplace_back([&queue, p] {
+				for (uint64_t i = 0; i < perProducer; ++i) {
+					// mix blocking and non-blocking
+					if (i % 2 == 0) {
+						queue.Push(p * perProducer + i);
+					} else {
+						while (!queue.TryPush(p * perProducer + i)) {
+							std::this_thread::yield();
+						}
+					}
+				}
+			});
+		}
+		for (size_t c = 0; c < consumers; ++c) {
+			threads.emplace_back([&queue, &sum, &received] {
+				for (uint64_t i = 0; i < producers * perProducer / consumers; ++i) {
+					uint64_t value;
+					queue.Pop(value);
+					sum += value;
+					++received;
+				}
+			});
+		}
+	}
+
+	constexpr uint64_t total = producers * perProducer;
+	EXPECT_EQ(received, total);
+	EXPECT_EQ(sum, total * (total - 1) / 2);
+	EXPECT_TRUE(queue.Empty());
+}
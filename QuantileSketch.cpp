@@ -0,0 +1,167 @@
+#include "QuantileSketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+ArcdpsExtension::QuantileSketch::QuantileSketch(double pRelativeAccuracy, size_t pMaxBuckets)
+	: mRelativeAccuracy(pRelativeAccuracy),
+	  mGamma((1. + pRelativeAccuracy) / (1. - pRelativeAccuracy)),
+	  mLogGamma(std::log(mGamma)),
+	  mMaxBuckets(std::max<size_t>(pMaxBuckets, 1)) {}
+
+void ArcdpsExtension::QuantileSketch::Add(double pValue) {
+	if (mCount == 0) {
+		mMin = mMax = pValue;
+	} else {
+		mMin = std::min(mMin, pValue);
+		mMax = std::max(mMax, pValue);
+	}
+	++mCount;
+	mSum += pValue;
+
+	if (pValue <= 0.) {
+		++mZeroCount;
+		return;
+	}
+	addToBucket(key(pValue), 1);
+}
+
+bool ArcdpsExtension::QuantileSketch::Merge(const QuantileSketch& pOther) {
+	if (std::abs(mRelativeAccuracy - pOther.mRelativeAccuracy) > 1e-12) {
+		return false;
+	}
+	if (pOther.mCount == 0) {
+		return true;
+	}
+
+	if (mCount == 0) {
+		mMin = pOther.mMin;
+		mMax = pOther.mMax;
+	} else {
+		mMin = std::min(mMin, pOther.mMin);
+		mMax = std::max(mMax, pOther.mMax);
+	}
+	mCount += pOther.mCount;
+	mSum += pOther.mSum;
+	mZeroCount += pOther.mZeroCount;
+
+	for (size_t i = 0; i < pOther.mBuckets.size(); ++i) {
+		if (pOther.mBuckets[i] > 0) {
+			addToBucket(pOther.mOffset + static_cast<int32_t>(i), pOther.mBuckets[i]);
+		}
+	}
+	return true;
+}
+
+double ArcdpsExtension::QuantileSketch::Quantile(double pQuantile) const {
+	if (mCount == 0) {
+		return 0.;
+	}
+
+	const double rank = std::clamp(pQuantile, 0., 1.) * static_cast<double>(mCount - 1);
+	uint64_t seen = mZeroCount;
+	if (rank < static_cast<double>(seen)) {
+		return std::min(0., mMax);
+	}
+
+	for (size_t i = 0; i < mBuckets.size(); ++i) {
+		seen += mBuckets[i];
+		if (rank < static_cast<double>(seen)) {
+			return std::clamp(value(mOffset + static_cast<int32_t>(i)), mMin, mMax);
+		}
+	}
+	return mMax;
+}
+
+void ArcdpsExtension::QuantileSketch::Clear() {
+	mBuckets.clear();
+	mOffset = 0;
+	mZeroCount = 0;
+	mCount = 0;
+	mSum = 0.;
+	mMin = 0.;
+	mMax = 0.;
+}
+
+int32_t ArcdpsExtension::QuantileSketch::key(double pValue) const {
+	return static_cast<int32_t>(std::ceil(std::log(pValue) / mLogGamma));
+}
+
+double ArcdpsExtension::QuantileSketch::value(int32_t pKey) const {
+	// center of the bucket (gamma^(key-1), gamma^key] with relative error
+	return 2. * std::pow(mGamma, pKey) / (mGamma + 1.);
+}
+
+void ArcdpsExtension::QuantileSketch::addToBucket(int32_t pKey, uint64_t pCount) {
+	if (mBuckets.empty()) {
+		mOffset = pKey;
+		mBuckets.push_back(pCount);
+		return;
+	}
+
+	if (pKey < mOffset) {
+		// grow to the front as far as allowed, everything lower is collapsed into the lowest bucket
+		const auto space = static_cast<int32_t>(mMaxBuckets - mBuckets.size());
+		const int32_t newOffset = std::max(pKey, mOffset - space);
+		mBuckets.insert(mBuckets.begin(), mOffset - newOffset, 0);
+		mOffset = newOffset;
+		mBuckets.front() += pCount;
+		return;
+	}
+
+	const auto index = static_cast<size_t>(pKey - mOffset);
+	if (index >= mBuckets.size()) {
+		mBuckets.resize(index + 1, 0);
+
+		// collapse the lowest buckets
+		if (mBuckets.size() > mMaxBuckets) {
+			const size_t excess = mBuckets.size() - mMaxBuckets;
+			mBuckets[excess] += std::accumulate(mBuckets.begin(), mBuckets.begin() + excess, uint64_t{0});
+			mBuckets.erase(mBuckets.begin(), mBuckets.begin() + excess);
+			mOffset += static_cast<int32_t>(excess);
+			mBuckets[index - excess] += pCount;
+			return;
+		}
+	}
+	mBuckets[index] += pCount;
+}
+
+void ArcdpsExtension::HitSizeSketches::Strike(const cbtevent& pEvent) {
+	if (pEvent.value <= 0) {
+		return;
+	}
+	switch (pEvent.result) {
+		case CBTR_STRIKE_DAMAGENORMAL:
+		case CBTR_STRIKE_DAMAGEGLANCE:
+			get({pEvent.src_agent, pEvent.skillid}).All.Add(pEvent.value);
+			break;
+		case CBTR_STRIKE_DAMAGECRIT: {
+			auto& sketches = get({pEvent.src_agent, pEvent.skillid});
+			sketches.All.Add(pEvent.value);
+			sketches.Crit.Add(pEvent.value);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+const ArcdpsExtension::HitSizeSketches::Sketches* ArcdpsExtension::HitSizeSketches::Find(uintptr_t pAgent, uint32_t pSkillId) const {
+	if (const auto it = mSketches.find({pAgent, pSkillId}); it != mSketches.end()) {
+		return &it->second;
+	}
+	return nullptr;
+}
+
+void ArcdpsExtension::HitSizeSketches::Merge(const HitSizeSketches& pOther) {
+	for (const auto& [key, sketches] : pOther.mSketches) {
+		auto& own = get(key);
+		own.All.Merge(sketches.All);
+		own.Crit.Merge(sketches.Crit);
+	}
+}
+
+ArcdpsExtension::HitSizeSketches::Sketches& ArcdpsExtension::HitSizeSketches::get(const Key& pKey) {
+	return mSketches.try_emplace(pKey, Sketches{QuantileSketch(mRelativeAccuracy), QuantileSketch(mRelativeAccuracy)}).first->second;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "arcdps_structs_slim.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace ArcdpsExtension {
+	/**
+	 * Streaming quantile estimation with a bounded relative error (DDSketch).
+	 * Values are counted in logarithmic buckets, every reported quantile is within `RelativeAccuracy` of the real value.
+	 * Insert is O(1), memory is bounded by `MaxBuckets`. If more buckets are needed, the lowest ones are collapsed,
+	 * so only the accuracy of the lowest quantiles suffers.
+	 * Two sketches with the same accuracy can be merged, e.g. to combine subgroups or multiple fights.
+	 * <br>
+	 * Values <= 0 are counted in a separate zero bucket.
+	 */
+	class QuantileSketch {
+	public:
+		static constexpr double DefaultRelativeAccuracy = 0.01;
+		static constexpr size_t DefaultMaxBuckets = 1024;
+
+		explicit QuantileSketch(double pRelativeAccuracy = DefaultRelativeAccuracy, size_t pMaxBuckets = DefaultMaxBuckets);
+
+		void Add(double pValue);
+
+		/**
+		 * Add all values of the other sketch to this one.
+		 * @return `false` if the sketches have a different accuracy, nothing is merged then.
+		 */
+		bool Merge(const QuantileSketch& pOther);
+
+		/**
+		 * @param pQuantile between 0 and 1 (0.5 is the median)
+		 * @return The estimated value at this quantile, 0 if the sketch is empty.
+		 */
+		[[nodiscard]] double Quantile(double pQuantile) const;
+
+		[[nodiscard]] uint64_t Count() const {
+			return mCount;
+		}
+		[[nodiscard]] double Sum() const {
+			return mSum;
+		}
+		[[nodiscard]] double Min() const {
+			return mMin;
+		}
+		[[nodiscard]] double Max() const {
+			return mMax;
+		}
+		[[nodiscard]] double Mean() const {
+			return mCount > 0 ? mSum / static_cast<double>(mCount) : 0.;
+		}
+		[[nodiscard]] double RelativeAccuracy() const {
+			return mRelativeAccuracy;
+		}
+
+		void Clear();
+
+	private:
+		double mRelativeAccuracy;
+		double mGamma;
+		double mLogGamma;
+		size_t mMaxBuckets;
+
+		std::vector<uint64_t> mBuckets;
+		int32_t mOffset = 0; // key of mBuckets[0]
+		uint64_t mZeroCount = 0;
+		uint64_t mCount = 0;
+		double mSum = 0.;
+		double mMin = 0.;
+		double mMax = 0.;
+
+		[[nodiscard]] int32_t key(double pValue) const;
+		[[nodiscard]] double value(int32_t pKey) const;
+		void addToBucket(int32_t pKey, uint64_t pCount);
+	};
+
+	/**
+	 * Hit size distribution per (agent, skill), fed with `Strike` events.
+	 * Keeps one sketch with all damaging hits and one with crits only.
+	 * <br>
+	 * Usage:
+	 * @code
+	 * void Strike(uint64_t pTime, cbtevent* pEvent, const ag& pSrc, const ag& pDst, const char* pSkillname, uint64_t pId) override {
+	 * 	mHitSizes.Strike(*pEvent);
+	 * }
+	 * // later
+	 * if (const auto* sketches = mHitSizes.Find(agent, skill)) {
+	 * 	double median = sketches->Crit.Quantile(0.5);
+	 * 	double p95 = sketches->Crit.Quantile(0.95);
+	 * }
+	 * @endcode
+	 */
+	class HitSizeSketches {
+	public:
+		struct Key {
+			uintptr_t Agent;
+			uint32_t SkillId;
+
+			bool operator==(const Key&) const = default;
+		};
+
+		struct Sketches {
+			QuantileSketch All;
+			QuantileSketch Crit;
+		};
+
+		explicit HitSizeSketches(double pRelativeAccuracy = QuantileSketch::DefaultRelativeAccuracy) : mRelativeAccuracy(pRelativeAccuracy) {}
+
+		/**
+		 * Add the strike, if it did damage (normal, crit or glance).
+		 */
+		void Strike(const cbtevent& pEvent);
+
+		[[nodiscard]] const Sketches* Find(uintptr_t pAgent, uint32_t pSkillId) const;
+
+		/**
+		 * Merge all sketches of the other table into this one (e.g. the last fight into a session total).
+		 */
+		void Merge(const HitSizeSketches& pOther);
+
+		void Clear() {
+			mSketches.clear();
+		}
+
+		[[nodiscard]] size_t Size() const {
+			return mSketches.size();
+		}
+
+		[[nodiscard]] auto begin() const {
+			return mSketches.begin();
+		}
+		[[nodiscard]] auto end() const {
+			return mSketches.end();
+		}
+
+	private:
+		struct KeyHash {
+			size_t operator()(const Key& pKey) const {
+				return std::hash<uint64_t>()(static_cast<uint64_t>(pKey.Agent) * 0x9E3779B97F4A7C15ull ^ pKey.SkillId);
+			}
+		};
+
+		double mRelativeAccuracy;
+		std::unordered_map<Key, Sketches, KeyHash> mSketches;
+
+		Sketches& get(const Key& pKey);
+	};
+} // namespace ArcdpsExtension
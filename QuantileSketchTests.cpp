@@ -0,0 +1,119 @@
+#include "arcdps_structs_slim.h"
+#include "QuantileSketch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace ArcdpsExtension;
+
+namespace {
+	double ExactQuantile(std::vector<double> pValues, double pQuantile) {
+		std::ranges::sort(pValues);
+		return pValues[static_cast<size_t>(pQuantile * static_cast<double>(pValues.size() - 1))];
+	}
+} // namespace
+
+TEST(QuantileSketchTests, Empty) {
+	QuantileSketch sketch;
+	EXPECT_EQ(sketch.Count(), 0);
+	EXPECT_EQ(sketch.Quantile(0.5), 0.);
+}
+
+TEST(QuantileSketchTests, RelativeError) {
+	std::mt19937_64 rng(42);
+	std::lognormal_distribution<double> dist(8., 1.);
+
+	QuantileSketch sketch(0.01);
+	std::vector<double> values;
+	for (int i = 0; i < 100000; ++i) {
+		double value = dist(rng);
+		values.push_back(value);
+		sketch.Add(value);
+	}
+
+	EXPECT_EQ(sketch.Count(), values.size());
+	EXPECT_EQ(sketch.Min(), *std::ranges::min_element(values));
+	EXPECT_EQ(sketch.Max(), *std::ranges::max_element(values));
+	for (double quantile : {0., 0.1, 0.5, 0.9, 0.95, 0.99, 1.}) {
+		double exact = ExactQuantile(values, quantile);
+		EXPECT_NEAR(sketch.Quantile(quantile), exact, exact * 0.01) << quantile;
+	}
+}
+
+TEST(QuantileSketchTests, ZeroValues) {
+	QuantileSketch sketch;
+	sketch.Add(0);
+	sketch.Add(0);
+	sketch.Add(100);
+
+	EXPECT_EQ(sketch.Quantile(0.), 0.);
+	EXPECT_EQ(sketch.Quantile(0.5), 0.);
+	EXPECT_NEAR(sketch.Quantile(1.), 100., 1.);
+}
+
+TEST(QuantileSketchTests, BoundedBuckets) {
+	QuantileSketch sketch(0.01, 64);
+	for (double value = 1.; value < 1e9; value *= 1.01) {
+		sketch.Add(value);
+	}
+
+	// the highest quantiles are still accurate, the lowest ones are collapsed
+	EXPECT_NEAR(sketch.Quantile(1.), sketch.Max(), sketch.Max() * 0.01);
+	EXPECT_GT(sketch.Quantile(0.), 1.);
+}
+
+TEST(QuantileSketchTests, Merge) {
+	QuantileSketch first;
+	QuantileSketch second;
+	QuantileSketch all;
+	for (int i = 1; i <= 1000; ++i) {
+		(i % 2 == 0 ? first : second).Add(i);
+		all.Add(i);
+	}
+
+	ASSERT_TRUE(first.Merge(second));
+	EXPECT_EQ(first.Count(), all.Count());
+	EXPECT_EQ(first.Sum(), all.Sum());
+	EXPECT_EQ(first.Min(), 1.);
+	EXPECT_EQ(first.Max(), 1000.);
+	for (double quantile : {0.1, 0.5, 0.95}) {
+		EXPECT_EQ(first.Quantile(quantile), all.Quantile(quantile));
+	}
+
+	QuantileSketch other(0.05);
+	EXPECT_FALSE(first.Merge(other));
+}
+
+TEST(QuantileSketchTests, HitSizeSketches) {
+	HitSizeSketches hitSizes;
+
+	cbtevent event{};
+	event.src_agent = 1;
+	event.skillid = 5;
+	event.value = 1000;
+	event.result = CBTR_STRIKE_DAMAGENORMAL;
+	hitSizes.Strike(event);
+
+	event.value = 2000;
+	event.result = CBTR_STRIKE_DAMAGECRIT;
+	hitSizes.Strike(event);
+
+	// no damage
+	event.result = CBTR_BLOCK;
+	hitSizes.Strike(event);
+
+	const auto* sketches = hitSizes.Find(1, 5);
+	ASSERT_NE(sketches, nullptr);
+	EXPECT_EQ(sketches->All.Count(), 2);
+	EXPECT_EQ(sketches->Crit.Count(), 1);
+	EXPECT_NEAR(sketches->Crit.Quantile(0.5), 2000., 20.);
+	EXPECT_EQ(hitSizes.Find(2, 5), nullptr);
+
+	HitSizeSketches session;
+	session.Merge(hitSizes);
+	session.Merge(hitSizes);
+	EXPECT_EQ(session.Find(1, 5)->All.Count(), 4);
+}
@@ -1,7 +1,13 @@
 #include "SimpleNetworkStack.h"
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
 #include <iostream>
 #include <cstdio>
+#include <ctime>
+#include <exception>
 #include <stdexcept>
 
 ArcdpsExtension::SimpleNetworkStack::SimpleNetworkStack() {
@@ -12,127 +18,962 @@ ArcdpsExtension::SimpleNetworkStack::SimpleNetworkStack() {
 		throw std::runtime_error("Failed to initialize libcurl");
 	}
 
+	mMultiHandle = curl_multi_init();
+	if (!mMultiHandle) {
+		std::cout << "curl_multi_init() failed" << std::endl;
+		curl_easy_cleanup(mHandle);
+		throw std::runtime_error("Failed to initialize libcurl");
+	}
+	// several transfers to the same host share one HTTP/2 connection, if the server supports it
+	curl_multi_setopt(mMultiHandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+	// The multi handle already keeps DNS results and open connections, but TLS sessions are cached per transfer handle.
+	// The share gives all transfer handles one cache of each, so sessions can be resumed by any of them.
+	// Only the runner thread uses it, so the share needs no lock functions.
+	// Without the share everything still works, just with more full TLS handshakes.
+	mShareHandle = curl_share_init();
+	if (mShareHandle) {
+		curl_share_setopt(mShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+		curl_share_setopt(mShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+		curl_share_setopt(mShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+	} else {
+		std::cout << "curl_share_init() failed" << std::endl;
+	}
+
 	mThread = std::move(std::jthread([this](const std::stop_token& stopToken) {
 		runner(stopToken);
 	}));
 }
 
-ArcdpsExtension::SimpleNetworkStack::Result ArcdpsExtension::SimpleNetworkStack::get(const QueueElement& pElement) {
-	mLastResponseBuffer.clear();
-	curl_easy_reset(mHandle);
+std::expected<void, ArcdpsExtension::SimpleNetworkStack::Error> ArcdpsExtension::SimpleNetworkStack::setup(Transfer& pTransfer) {
+	CURL* handle = pTransfer.Handle;
+	const QueueElement& element = pTransfer.Element;
 
-	// if (auto res = curl_easy_setopt(mHandle, CURLOPT_VERBOSE, 1L); res != CURLE_OK) {
+	// if (auto res = curl_easy_setopt(handle, CURLOPT_VERBOSE, 1L); res != CURLE_OK) {
 	// 	return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
 	// }
-	if (auto res = curl_easy_setopt(mHandle, CURLOPT_SSL_OPTIONS , CURLSSLOPT_NATIVE_CA ); res != CURLE_OK) {
+	if (auto res = curl_easy_setopt(handle, CURLOPT_PRIVATE, &pTransfer); res != CURLE_OK) {
+		return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
+	}
+	if (auto res = curl_easy_setopt(handle, CURLOPT_SSL_OPTIONS , CURLSSLOPT_NATIVE_CA ); res != CURLE_OK) {
 		return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
 	}
-	if (auto res = curl_easy_setopt(mHandle, CURLOPT_URL, pElement.Url.c_str()); res != CURLE_OK) {
+	// `curl_easy_reset` cleared it, when the handle was used before
+	if (mShareHandle) {
+		if (auto res = curl_easy_setopt(handle, CURLOPT_SHARE, mShareHandle); res != CURLE_OK) {
+			return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
+		}
+	}
+	// HTTP/2 over TLS where the server offers it, HTTP/1.1 otherwise.
+	// Fails if libcurl is built without HTTP/2, which is fine, it falls back to HTTP/1.1 then
+	curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+	// wait for a connection that is still being set up, instead of opening another one next to it
+	if (auto res = curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L); res != CURLE_OK) {
+		return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
+	}
+	if (auto res = curl_easy_setopt(handle, CURLOPT_URL, element.Url.c_str()); res != CURLE_OK) {
 		return std::unexpected(Error{ErrorType::OptUrlError, curl_easy_strerror(res)});
 	}
-	if (auto res = curl_easy_setopt(mHandle, CURLOPT_FOLLOWLOCATION, 1l); res != CURLE_OK) {
+	if (auto res = curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1l); res != CURLE_OK) {
 		return std::unexpected(Error{ErrorType::OptFollowLocationError, curl_easy_strerror(res)});
 	}
-	if (auto res = curl_easy_setopt(mHandle, CURLOPT_USERAGENT, mUserAgent.c_str())) {
+	if (auto res = curl_easy_setopt(handle, CURLOPT_USERAGENT, mUserAgent.c_str())) {
 		return std::unexpected(Error{ErrorType::OptUseragentError, curl_easy_strerror(res)});
 	}
+	// checks for cancellation while the transfer is running
+	if (auto res = curl_easy_setopt(handle, CURLOPT_XFERINFOFUNCTION, ProgressFunction); res != CURLE_OK) {
+		return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
+	}
+	if (auto res = curl_easy_setopt(handle, CURLOPT_XFERINFODATA, &pTransfer); res != CURLE_OK) {
+		return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
+	}
+	if (auto res = curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 0L); res != CURLE_OK) {
+		return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
+	}
+	if (auto res = curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, HeaderFunction); res != CURLE_OK) {
+		return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
+	}
+	if (auto res = curl_easy_setopt(handle, CURLOPT_HEADERDATA, &pTransfer.ResponseHeaders); res != CURLE_OK) {
+		return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
+	}
+
+	// conditional GET, the server answers with 304 if the cached body is still valid
+	if (pTransfer.CachedEntry) {
+		if (!pTransfer.CachedEntry->ETag.empty()) {
+			pTransfer.RequestHeaders = curl_slist_append(pTransfer.RequestHeaders, ("If-None-Match: " + pTransfer.CachedEntry->ETag).c_str());
+		}
+		if (!pTransfer.CachedEntry->LastModified.empty()) {
+			pTransfer.RequestHeaders = curl_slist_append(pTransfer.RequestHeaders, ("If-Modified-Since: " + pTransfer.CachedEntry->LastModified).c_str());
+		}
+		if (auto res = curl_easy_setopt(handle, CURLOPT_HTTPHEADER, pTransfer.RequestHeaders); res != CURLE_OK) {
+			return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
+		}
+	}
 
-	FILE* fp = nullptr;
 	// set write data if there is a response
-	if (pElement.Filepath.empty()) {
-		if (auto res = curl_easy_setopt(mHandle, CURLOPT_WRITEFUNCTION, ResponseBufferWriteFunction); res != CURLE_OK) {
+	if (element.Sink) {
+		if (auto res = curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, StreamWriteFunction); res != CURLE_OK) {
 			return std::unexpected(Error{ErrorType::OptWriteFuncError, curl_easy_strerror(res)});
 		}
-		if (auto res = curl_easy_setopt(mHandle, CURLOPT_WRITEDATA, &mLastResponseBuffer); res != CURLE_OK) {
+		if (auto res = curl_easy_setopt(handle, CURLOPT_WRITEDATA, &pTransfer); res != CURLE_OK) {
 			return std::unexpected(Error{ErrorType::OptWriteDataError, curl_easy_strerror(res)});
 		}
-	} else {
-		if (auto res = curl_easy_setopt(mHandle, CURLOPT_WRITEFUNCTION, NULL); res != CURLE_OK) {
+	} else if (element.Filepath.empty()) {
+		if (auto res = curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, ResponseBufferWriteFunction); res != CURLE_OK) {
 			return std::unexpected(Error{ErrorType::OptWriteFuncError, curl_easy_strerror(res)});
 		}
-		fopen_s(&fp, pElement.Filepath.string().c_str(), "wb");
-		if (auto res = curl_easy_setopt(mHandle, CURLOPT_WRITEDATA, fp); res != CURLE_OK) {
+		if (auto res = curl_easy_setopt(handle, CURLOPT_WRITEDATA, &pTransfer); res != CURLE_OK) {
 			return std::unexpected(Error{ErrorType::OptWriteDataError, curl_easy_strerror(res)});
 		}
-	}
-
-	auto res = curl_easy_perform(mHandle);
-	if (fp != nullptr) {
-		fclose(fp);
-	}
-	if (res == CURLE_OK) {
-		curl_easy_getinfo(mHandle, CURLINFO_RESPONSE_CODE, &mLastResponseCode);
 	} else {
-		return std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(res)});
+		if (auto res = curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, NULL); res != CURLE_OK) {
+			return std::unexpected(Error{ErrorType::OptWriteFuncError, curl_easy_strerror(res)});
+		}
+		fopen_s(&pTransfer.File, element.Filepath.string().c_str(), "wb");
+		if (pTransfer.File == nullptr) {
+			// curl would write to stdout without a file
+			return std::unexpected(Error{ErrorType::OptWriteDataError, "Failed to open " + element.Filepath.string()});
+		}
+		if (auto res = curl_easy_setopt(handle, CURLOPT_WRITEDATA, pTransfer.File); res != CURLE_OK) {
+			return std::unexpected(Error{ErrorType::OptWriteDataError, curl_easy_strerror(res)});
+		}
 	}
 
-	return Response{mLastResponseBuffer, mLastResponseCode};
+	return {};
 }
 
 ArcdpsExtension::SimpleNetworkStack::~SimpleNetworkStack() {
 	if (mThread.joinable()) {
 		mThread.request_stop();
+		// the runner might be in `curl_multi_poll`
+		curl_multi_wakeup(mMultiHandle);
 		mThread.join();
 	}
+	curl_multi_cleanup(mMultiHandle);
+	// all transfer handles are cleaned up by the runner, the share isn't in use anymore
+	if (mShareHandle) {
+		curl_share_cleanup(mShareHandle);
+	}
 	curl_easy_cleanup(mHandle);
 }
 
 size_t ArcdpsExtension::SimpleNetworkStack::ResponseBufferWriteFunction(void* pContent, size_t pSize, size_t pNMemb, void* pUserP) {
-	static_cast<std::string*>(pUserP)->append(static_cast<char*>(pContent), pSize * pNMemb);
+	auto& transfer = *static_cast<Transfer*>(pUserP);
+	// exceptions must not pass through libcurl, returning less than given aborts the transfer
+	try {
+		if (transfer.Buffer.empty()) {
+			// allocate once for the whole body, instead of growing with every chunk.
+			// Content-Length comes from the server, so it is capped, bigger bodies grow as usual
+			curl_off_t length = -1;
+			if (curl_easy_getinfo(transfer.Handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length) == CURLE_OK && length > 0) {
+				transfer.Buffer.reserve(std::min(static_cast<uint64_t>(length), MaxReservedBodySize));
+			}
+		}
+		transfer.Buffer.append(static_cast<char*>(pContent), pSize * pNMemb);
+	} catch (const std::exception&) {
+		return 0;
+	}
 	return pSize * pNMemb;
 }
 
-void ArcdpsExtension::SimpleNetworkStack::runner(const std::stop_token& pToken) {
-	while (true) {
-		std::unique_lock lock(mQueueMutex);
-
-		// wait until something returned
-		mQueueCv.wait(lock, pToken, [this]() {
-			return !mJobQueue.empty();
-		});
-		if (pToken.stop_requested()) {
-			break;
+size_t ArcdpsExtension::SimpleNetworkStack::StreamWriteFunction(void* pContent, size_t pSize, size_t pNMemb, void* pUserP) {
+	auto& transfer = *static_cast<Transfer*>(pUserP);
+	// the sink might refer to something that doesn't exist anymore, returning less than given aborts the transfer
+	if (transfer.Element.Cancelled->load(std::memory_order_relaxed)) {
+		return 0;
+	}
+	try {
+		if (!transfer.Element.Sink(std::string_view(static_cast<char*>(pContent), pSize * pNMemb))) {
+			return 0;
 		}
-		auto element = std::move(mJobQueue.front());
-		mJobQueue.pop();
+	} catch (const std::exception&) {
+		return 0;
+	}
+	return pSize * pNMemb;
+}
 
-		lock.unlock();
+size_t ArcdpsExtension::SimpleNetworkStack::HeaderFunction(char* pBuffer, size_t pSize, size_t pNItems, void* pUserData) {
+	auto& headers = *static_cast<HttpCache::Headers*>(pUserData);
+	std::string_view line(pBuffer, pSize * pNItems);
 
-		auto response = get(element);
+	// a new status line starts the headers of the next response (redirects)
+	if (line.starts_with("HTTP/")) {
+		headers.clear();
+		return pSize * pNItems;
+	}
 
-		if (auto* func = std::get_if<ResultFunc>(&element.Callback)) {
-			(*func)(response);
-		} else if (auto* promise = std::get_if<ResultPromise>(&element.Callback)) {
-			promise->set_value(response);
+	const size_t colon = line.find(':');
+	if (colon != std::string_view::npos) {
+		std::string name(line.substr(0, colon));
+		std::ranges::transform(name, name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		std::string_view value = line.substr(colon + 1);
+		while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front()))) {
+			value.remove_prefix(1);
+		}
+		while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) {
+			value.remove_suffix(1);
 		}
+		headers[name] = value;
 	}
+	return pSize * pNItems;
 }
 
-void ArcdpsExtension::SimpleNetworkStack::QueueGet(const std::string& pUrl, const std::filesystem::path& pFilepath) {
+void ArcdpsExtension::SimpleNetworkStack::SetCacheDirectory(const std::filesystem::path& pDirectory) {
+	auto cache = pDirectory.empty() ? nullptr : std::make_shared<HttpCache>(pDirectory);
+
 	std::lock_guard lock(mQueueMutex);
+	mCache = std::move(cache);
+}
 
-	mJobQueue.emplace(pUrl, std::monostate(), pFilepath);
+ArcdpsExtension::SimpleNetworkStack::CacheStats ArcdpsExtension::SimpleNetworkStack::GetCacheStats() const {
+	return {mCacheHits.load(), mCacheMisses.load(), mCacheRevalidations.load()};
+}
 
-	mQueueCv.notify_one();
+std::optional<ArcdpsExtension::SimpleNetworkStack::Response> ArcdpsExtension::SimpleNetworkStack::loadCached(Transfer& pTransfer) {
+	const QueueElement& element = pTransfer.Element;
+	Response response{"", pTransfer.CachedEntry->Code, true};
+	if (element.Filepath.empty()) {
+		if (!pTransfer.Cache->ReadBody(element.Url, response.Message)) {
+			return std::nullopt;
+		}
+	} else if (!pTransfer.Cache->CopyBody(element.Url, element.Filepath)) {
+		return std::nullopt;
+	}
+	return response;
+}
+
+std::optional<ArcdpsExtension::SimpleNetworkStack::Response> ArcdpsExtension::SimpleNetworkStack::complete(Transfer& pTransfer, long pCode) {
+	if (!pTransfer.Cache) {
+		return Response{std::move(pTransfer.Buffer), pCode};
+	}
+
+	const QueueElement& element = pTransfer.Element;
+	if (pCode == 304 && pTransfer.CachedEntry) {
+		pTransfer.Cache->Refresh(*pTransfer.CachedEntry, pTransfer.ResponseHeaders);
+		if (auto cached = loadCached(pTransfer)) {
+			++mCacheRevalidations;
+			return std::move(*cached);
+		}
+		// a bare 304 is useless to the caller
+		pTransfer.Cache->Remove(element.Url);
+		return std::nullopt;
+	}
+
+	++mCacheMisses;
+	if (element.Filepath.empty()) {
+		pTransfer.Cache->Store(element.Url, pCode, pTransfer.ResponseHeaders, pTransfer.Buffer);
+	} else {
+		pTransfer.Cache->StoreFile(element.Url, pCode, pTransfer.ResponseHeaders, element.Filepath);
+	}
+	return Response{std::move(pTransfer.Buffer), pCode};
+}
+
+void ArcdpsExtension::SimpleNetworkStack::SetMaxConcurrentTransfers(size_t pMaxTransfers) {
+	mMaxTransfers.store(std::max<size_t>(pMaxTransfers, 1), std::memory_order_relaxed);
+	// raising the limit can start queued jobs right away
+	curl_multi_wakeup(mMultiHandle);
+}
+
+int ArcdpsExtension::SimpleNetworkStack::ProgressFunction(void* pClientP, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+	auto& transfer = *static_cast<Transfer*>(pClientP);
+	return transfer.Owner->abandoned(transfer.Element) ? 1 : 0;
 }
-void ArcdpsExtension::SimpleNetworkStack::QueueGet(const std::string& pUrl, const SimpleNetworkStack::ResultFunc& pFunc, const std::filesystem::path& pFilepath) {
+
+bool ArcdpsExtension::SimpleNetworkStack::abandoned(const QueueElement& pElement) const {
+	// only lock, if the request itself was cancelled, coalesced requests might still need the result
+	if (!pElement.Cancelled->load(std::memory_order_relaxed)) {
+		return false;
+	}
 	std::lock_guard lock(mQueueMutex);
+	return cancelled(pElement);
+}
 
-	mJobQueue.emplace(pUrl, pFunc, pFilepath);
+bool ArcdpsExtension::SimpleNetworkStack::cancelled(const QueueElement& pElement) const {
+	if (!pElement.Cancelled->load(std::memory_order_relaxed)) {
+		return false;
+	}
+	if (auto it = mFollowers.find(pElement.Key()); it != mFollowers.end()) {
+		return std::ranges::all_of(it->second, [](const QueueElement& pFollower) {
+			return pFollower.Cancelled->load(std::memory_order_relaxed);
+		});
+	}
+	return true;
+}
 
-	mQueueCv.notify_one();
+bool ArcdpsExtension::SimpleNetworkStack::queuesEmpty() const {
+	return std::ranges::all_of(mJobQueues, [](const auto& pQueue) { return pQueue.empty(); });
 }
-void ArcdpsExtension::SimpleNetworkStack::QueueGet(const std::string& pUrl, std::promise<Result> pPromise, const std::filesystem::path& pFilepath) {
+
+std::optional<size_t> ArcdpsExtension::SimpleNetworkStack::QueuePosition(const RequestHandle& pHandle) const {
+	if (!pHandle.Valid() || pHandle.Cancelled()) {
+		return std::nullopt;
+	}
+
+	std::lock_guard lock(mQueueMutex);
+	size_t position = 0;
+	for (const auto& queue : mJobQueues) {
+		for (const auto& element : queue) {
+			bool found = element.Cancelled == pHandle.mCancelled;
+			if (!found) {
+				if (auto it = mFollowers.find(element.Key()); it != mFollowers.end()) {
+					found = std::ranges::any_of(it->second, [&pHandle](const QueueElement& pFollower) {
+						return pFollower.Cancelled == pHandle.mCancelled;
+					});
+				}
+			}
+			if (found) {
+				return position;
+			}
+			if (!cancelled(element)) {
+				++position;
+			}
+		}
+	}
+	return std::nullopt;
+}
+
+size_t ArcdpsExtension::SimpleNetworkStack::QueueSize() const {
 	std::lock_guard lock(mQueueMutex);
+	size_t size = 0;
+	for (const auto& queue : mJobQueues) {
+		size += queue.size();
+	}
+	return size;
+}
+
+void ArcdpsExtension::SimpleNetworkStack::dispatch(QueueElement& pElement, Result pResult) {
+	std::vector<QueueElement> followers;
+	{
+		// from now on, identical requests start a new transfer
+		std::lock_guard lock(mQueueMutex);
+		if (auto node = mFollowers.extract(pElement.Key()); !node.empty()) {
+			followers = std::move(node.mapped());
+		}
+	}
+
+	for (auto& follower : followers) {
+		resolve(follower, pResult, false);
+	}
+	// the body is only copied for coalesced promises
+	resolve(pElement, pResult, true);
+}
+
+void ArcdpsExtension::SimpleNetworkStack::resolve(QueueElement& pElement, Result& pResult, bool pLast) {
+	if (pElement.Cancelled->load(std::memory_order_relaxed)) {
+		// the callback might refer to something that doesn't exist anymore
+		if (auto* promise = std::get_if<ResultPromise>(&pElement.Callback)) {
+			promise->set_value(std::unexpected(Error{ErrorType::Cancelled, "Request was cancelled"}));
+		}
+		return;
+	}
+
+	if (auto* func = std::get_if<ResultFunc>(&pElement.Callback)) {
+		(*func)(pResult);
+	} else if (auto* promise = std::get_if<ResultPromise>(&pElement.Callback)) {
+		if (pLast) {
+			promise->set_value(std::move(pResult));
+		} else {
+			promise->set_value(pResult);
+		}
+	}
+}
+
+void ArcdpsExtension::SimpleNetworkStack::SetRetryPolicy(const RetryPolicy& pPolicy) {
+	std::lock_guard lock(mHostMutex);
+	mRetryPolicy = pPolicy;
+}
+
+ArcdpsExtension::SimpleNetworkStack::RetryPolicy ArcdpsExtension::SimpleNetworkStack::GetRetryPolicy() const {
+	std::lock_guard lock(mHostMutex);
+	return mRetryPolicy;
+}
+
+void ArcdpsExtension::SimpleNetworkStack::SetCircuitBreakerPolicy(const CircuitBreakerPolicy& pPolicy) {
+	std::lock_guard lock(mHostMutex);
+	mCircuitBreakerPolicy = pPolicy;
+}
+
+ArcdpsExtension::SimpleNetworkStack::CircuitBreakerPolicy ArcdpsExtension::SimpleNetworkStack::GetCircuitBreakerPolicy() const {
+	std::lock_guard lock(mHostMutex);
+	return mCircuitBreakerPolicy;
+}
+
+ArcdpsExtension::SimpleNetworkStack::CircuitState ArcdpsExtension::SimpleNetworkStack::GetCircuitState(const std::string& pHost) const {
+	std::lock_guard lock(mHostMutex);
+	auto it = mCircuits.find(pHost);
+	if (mCircuitBreakerPolicy.FailureThreshold == 0 || it == mCircuits.end() || it->second.Failures < mCircuitBreakerPolicy.FailureThreshold) {
+		return CircuitState::Closed;
+	}
+	if (std::chrono::steady_clock::now() < it->second.OpenUntil) {
+		return CircuitState::Open;
+	}
+	return CircuitState::HalfOpen;
+}
+
+std::string ArcdpsExtension::SimpleNetworkStack::GetHost(const std::string& pUrl) {
+	std::string host;
+	CURLU* url = curl_url();
+	if (url == nullptr) {
+		return host;
+	}
+	if (curl_url_set(url, CURLUPART_URL, pUrl.c_str(), 0) == CURLUE_OK) {
+		char* part = nullptr;
+		if (curl_url_get(url, CURLUPART_HOST, &part, 0) == CURLUE_OK) {
+			host = part;
+			curl_free(part);
+		}
+	}
+	curl_url_cleanup(url);
+	return host;
+}
+
+bool ArcdpsExtension::SimpleNetworkStack::transientFailure(CURLcode pCode, long pResponseCode) {
+	switch (pCode) {
+		case CURLE_OK:
+			return pResponseCode == 408 || pResponseCode == 429 || pResponseCode == 500 || pResponseCode == 502 || pResponseCode == 503 || pResponseCode == 504;
+		case CURLE_COULDNT_RESOLVE_HOST:
+		case CURLE_COULDNT_CONNECT:
+		case CURLE_OPERATION_TIMEDOUT:
+		case CURLE_SEND_ERROR:
+		case CURLE_RECV_ERROR:
+		case CURLE_GOT_NOTHING:
+		case CURLE_PARTIAL_FILE:
+		case CURLE_SSL_CONNECT_ERROR:
+		case CURLE_HTTP2:
+		case CURLE_HTTP2_STREAM:
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool ArcdpsExtension::SimpleNetworkStack::scheduleRetry(QueueElement& pElement) {
+	if (pElement.Sink || abandoned(pElement)) {
+		return false;
+	}
+
+	const RetryPolicy policy = GetRetryPolicy();
+	if (++pElement.Attempts >= policy.MaxAttempts) {
+		return false;
+	}
 
-	mJobQueue.emplace(pUrl, std::move(pPromise), pFilepath);
+	// exponential backoff, with "equal jitter": a random part of the delay is left out
+	const double exponential = static_cast<double>(policy.BaseDelay.count()) * std::pow(2.0, pElement.Attempts - 1);
+	double delay = std::min(exponential, static_cast<double>(policy.MaxDelay.count()));
+	delay *= 1.0 - std::clamp(policy.Jitter, 0.0, 1.0) * std::uniform_real_distribution<double>(0.0, 1.0)(mRandom);
+
+	const auto due = std::chrono::steady_clock::now() + std::chrono::milliseconds(static_cast<int64_t>(delay));
+	// every attempt needs its own token
+	pElement.Scheduled = false;
+	mDelayed.emplace_back(due, std::move(pElement));
+	return true;
+}
+
+void ArcdpsExtension::SimpleNetworkStack::promoteDelayed() {
+	const auto now = std::chrono::steady_clock::now();
+	auto due = std::ranges::partition(mDelayed, [now](const auto& pRetry) { return pRetry.first > now; });
+	if (due.empty()) {
+		return;
+	}
+
+	{
+		// retries and throttled requests already waited, they go before everything else of their priority
+		std::lock_guard lock(mQueueMutex);
+		for (auto& [time, element] : due) {
+			mJobQueues[static_cast<size_t>(element.Prio)].emplace_front(std::move(element));
+		}
+	}
+	mDelayed.erase(due.begin(), due.end());
+}
+
+std::optional<std::chrono::steady_clock::time_point> ArcdpsExtension::SimpleNetworkStack::nextDelayed() const {
+	if (mDelayed.empty()) {
+		return std::nullopt;
+	}
+	return std::ranges::min_element(mDelayed, {}, [](const auto& pRetry) { return pRetry.first; })->first;
+}
+
+bool ArcdpsExtension::SimpleNetworkStack::allowRequest(const std::string& pHost) {
+	std::lock_guard lock(mHostMutex);
+	auto it = mCircuits.find(pHost);
+	if (mCircuitBreakerPolicy.FailureThreshold == 0 || it == mCircuits.end() || it->second.Failures < mCircuitBreakerPolicy.FailureThreshold) {
+		return true;
+	}
+	Circuit& circuit = it->second;
+	if (std::chrono::steady_clock::now() < circuit.OpenUntil || circuit.TrialRunning) {
+		return false;
+	}
+	// half open, let a single request through to see if the host is back
+	circuit.TrialRunning = true;
+	return true;
+}
+
+void ArcdpsExtension::SimpleNetworkStack::recordOutcome(const std::string& pHost, Outcome pOutcome) {
+	std::lock_guard lock(mHostMutex);
+	if (pOutcome == Outcome::Success) {
+		mCircuits.erase(pHost);
+		return;
+	}
+
+	auto it = mCircuits.find(pHost);
+	if (pOutcome == Outcome::Unknown) {
+		if (it != mCircuits.end()) {
+			it->second.TrialRunning = false;
+		}
+		return;
+	}
+
+	Circuit& circuit = it == mCircuits.end() ? mCircuits[pHost] : it->second;
+	circuit.TrialRunning = false;
+	if (++circuit.Failures >= mCircuitBreakerPolicy.FailureThreshold && mCircuitBreakerPolicy.FailureThreshold > 0) {
+		circuit.OpenUntil = std::chrono::steady_clock::now() + mCircuitBreakerPolicy.OpenDuration;
+	}
+}
+
+void ArcdpsExtension::SimpleNetworkStack::SetRateLimit(const std::string& pHost, const RateLimit& pLimit) {
+	std::lock_guard lock(mHostMutex);
+	Bucket& bucket = mBuckets[pHost];
+	bucket.Limit = pLimit;
+	bucket.Tokens = pLimit.Burst;
+	bucket.LastRefill = std::chrono::steady_clock::now();
+}
+
+void ArcdpsExtension::SimpleNetworkStack::RemoveRateLimit(const std::string& pHost) {
+	std::lock_guard lock(mHostMutex);
+	auto it = mBuckets.find(pHost);
+	if (it == mBuckets.end()) {
+		return;
+	}
+	// a running pause from `Retry-After` is kept
+	it->second.Limit = RateLimit{};
+	if (it->second.Expired(std::chrono::steady_clock::now())) {
+		mBuckets.erase(it);
+	}
+}
+
+std::optional<ArcdpsExtension::SimpleNetworkStack::BucketState> ArcdpsExtension::SimpleNetworkStack::GetBucketState(const std::string& pHost) const {
+	std::lock_guard lock(mHostMutex);
+	auto it = mBuckets.find(pHost);
+	const auto now = std::chrono::steady_clock::now();
+	// expired buckets are erased when the host is asked again or another host is paused
+	if (it == mBuckets.end() || it->second.Expired(now)) {
+		return std::nullopt;
+	}
+	const Bucket& bucket = it->second;
+	const double elapsed = std::chrono::duration<double>(now - bucket.LastRefill).count();
+
+	BucketState state;
+	state.Limit = bucket.Limit;
+	state.Tokens = std::min(bucket.Limit.Burst, bucket.Tokens + elapsed * bucket.Limit.RequestsPerSecond);
+	if (bucket.BlockedUntil > now) {
+		state.BlockedFor = std::chrono::ceil<std::chrono::milliseconds>(bucket.BlockedUntil - now);
+	}
+	return state;
+}
+
+std::optional<std::chrono::steady_clock::time_point> ArcdpsExtension::SimpleNetworkStack::acquireToken(const std::string& pHost) {
+	std::lock_guard lock(mHostMutex);
+	auto it = mBuckets.find(pHost);
+	if (it == mBuckets.end()) {
+		return std::nullopt;
+	}
+	Bucket& bucket = it->second;
+	const auto now = std::chrono::steady_clock::now();
+	if (bucket.Expired(now)) {
+		mBuckets.erase(it);
+		return std::nullopt;
+	}
+	auto ready = std::max(now, bucket.BlockedUntil);
+
+	const double rate = bucket.Limit.RequestsPerSecond;
+	if (rate > 0) {
+		const double elapsed = std::chrono::duration<double>(now - bucket.LastRefill).count();
+		bucket.Tokens = std::min(bucket.Limit.Burst, bucket.Tokens + elapsed * rate);
+		bucket.LastRefill = now;
+
+		// the token is taken even if it isn't there yet, a negative count reserves the next ones in order
+		bucket.Tokens -= 1;
+		if (bucket.Tokens < 0) {
+			const auto wait = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(-bucket.Tokens / rate));
+			ready = std::max(ready, now + wait);
+		}
+	}
+
+	if (ready <= now) {
+		return std::nullopt;
+	}
+	return ready;
+}
+
+void ArcdpsExtension::SimpleNetworkStack::pauseHost(const std::string& pHost, const HttpCache::Headers& pHeaders) {
+	auto header = pHeaders.find("retry-after");
+	if (header == pHeaders.end()) {
+		return;
+	}
+
+	// either delay-seconds or an HTTP-date
+	std::chrono::seconds pause{0};
+	int64_t seconds = 0;
+	const std::string& value = header->second;
+	if (auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), seconds); ec == std::errc() && ptr == value.data() + value.size()) {
+		pause = std::chrono::seconds(seconds);
+	} else if (const time_t date = curl_getdate(value.c_str(), nullptr); date != -1) {
+		pause = std::chrono::seconds(date - std::time(nullptr));
+	}
+	if (pause.count() <= 0) {
+		return;
+	}
+	// don't let a broken server stall us forever
+	pause = std::min<std::chrono::seconds>(pause, std::chrono::hours(1));
+
+	std::lock_guard lock(mHostMutex);
+	const auto now = std::chrono::steady_clock::now();
+	// pauses of other hosts, that are never asked again, would stay forever otherwise
+	std::erase_if(mBuckets, [now](const auto& pEntry) { return pEntry.second.Expired(now); });
+	Bucket& bucket = mBuckets[pHost];
+	bucket.BlockedUntil = std::max(bucket.BlockedUntil, now + pause);
+}
+
+void ArcdpsExtension::SimpleNetworkStack::HostTimings::Add(const TransferTiming& pTiming) {
+	NameLookup.Add(pTiming.NameLookup);
+	Connect.Add(pTiming.Connect);
+	AppConnect.Add(pTiming.AppConnect);
+	StartTransfer.Add(pTiming.StartTransfer);
+	Total.Add(pTiming.Total);
+	Speed.Add(pTiming.Speed);
+	Bytes += pTiming.Size;
+}
+
+std::optional<ArcdpsExtension::SimpleNetworkStack::HostTimings> ArcdpsExtension::SimpleNetworkStack::GetTimings(const std::string& pHost) const {
+	std::lock_guard lock(mHostMutex);
+	auto it = mTimings.find(pHost);
+	if (it == mTimings.end()) {
+		return std::nullopt;
+	}
+	return it->second;
+}
+
+std::unordered_map<std::string, ArcdpsExtension::SimpleNetworkStack::HostTimings> ArcdpsExtension::SimpleNetworkStack::GetAllTimings() const {
+	std::lock_guard lock(mHostMutex);
+	return mTimings;
+}
+
+void ArcdpsExtension::SimpleNetworkStack::ResetTimings() {
+	std::lock_guard lock(mHostMutex);
+	mTimings.clear();
+}
+
+ArcdpsExtension::SimpleNetworkStack::TransferTiming ArcdpsExtension::SimpleNetworkStack::readTiming(CURL* pHandle) {
+	// the *_T variants are in microseconds
+	auto milliseconds = [pHandle](CURLINFO pInfo) {
+		curl_off_t value = 0;
+		curl_easy_getinfo(pHandle, pInfo, &value);
+		return static_cast<double>(value) / 1000.0;
+	};
+
+	TransferTiming timing;
+	timing.NameLookup = milliseconds(CURLINFO_NAMELOOKUP_TIME_T);
+	timing.Connect = milliseconds(CURLINFO_CONNECT_TIME_T);
+	timing.AppConnect = milliseconds(CURLINFO_APPCONNECT_TIME_T);
+	timing.StartTransfer = milliseconds(CURLINFO_STARTTRANSFER_TIME_T);
+	timing.Total = milliseconds(CURLINFO_TOTAL_TIME_T);
+
+	curl_off_t size = 0;
+	curl_easy_getinfo(pHandle, CURLINFO_SIZE_DOWNLOAD_T, &size);
+	timing.Size = static_cast<uint64_t>(size);
+	curl_off_t speed = 0;
+	curl_easy_getinfo(pHandle, CURLINFO_SPEED_DOWNLOAD_T, &speed);
+	timing.Speed = static_cast<double>(speed);
+	return timing;
+}
+
+void ArcdpsExtension::SimpleNetworkStack::recordTiming(const std::string& pHost, const TransferTiming& pTiming) {
+	std::lock_guard lock(mHostMutex);
+	mTimings[pHost].Add(pTiming);
+}
+
+void ArcdpsExtension::SimpleNetworkStack::startTransfers() {
+	while (mTransfers.size() < mMaxTransfers.load(std::memory_order_relaxed)) {
+		std::unique_lock lock(mQueueMutex);
+		auto queue = std::ranges::find_if(mJobQueues, [](const auto& pQueue) { return !pQueue.empty(); });
+		if (queue == mJobQueues.end()) {
+			break;
+		}
+		auto transfer = std::make_unique<Transfer>(std::move(queue->front()), this);
+		queue->pop_front();
+		if (!transfer->Element.Sink) {
+			transfer->Cache = mCache;
+		}
+		const bool dropped = cancelled(transfer->Element);
+		lock.unlock();
+
+		if (dropped) {
+			dispatch(transfer->Element, std::unexpected(Error{ErrorType::Cancelled, "Request was cancelled"}));
+			continue;
+		}
+
+		// fresh entries need no network access, neither the rate limit nor the circuit breaker apply
+		if (transfer->Cache) {
+			if (!transfer->Element.Unconditional) {
+				transfer->CachedEntry = transfer->Cache->Lookup(transfer->Element.Url);
+			}
+			if (transfer->CachedEntry && transfer->CachedEntry->Fresh(HttpCache::Now())) {
+				if (auto cached = loadCached(*transfer)) {
+					++mCacheHits;
+					dispatch(transfer->Element, *cached);
+					continue;
+				}
+			}
+			// without validator, it cannot be revalidated
+			if (transfer->CachedEntry && !transfer->CachedEntry->HasValidator()) {
+				transfer->CachedEntry.reset();
+			}
+		}
+
+		if (!transfer->Element.Scheduled) {
+			transfer->Element.Scheduled = true;
+			if (const auto ready = acquireToken(transfer->Element.Host)) {
+				// over the rate limit, it waits with the retries, other hosts go on
+				mDelayed.emplace_back(*ready, std::move(transfer->Element));
+				continue;
+			}
+		}
+		if (!allowRequest(transfer->Element.Host)) {
+			dispatch(transfer->Element, std::unexpected(Error{ErrorType::CircuitOpen, "Host '" + transfer->Element.Host + "' is not reachable"}));
+			continue;
+		}
+		// from here on, every path that doesn't start the transfer has to end a possible trial request with `Outcome::Unknown`
+		if (mIdleHandles.empty()) {
+			transfer->Handle = curl_easy_init();
+			if (!transfer->Handle) {
+				recordOutcome(transfer->Element.Host, Outcome::Unknown);
+				dispatch(transfer->Element, std::unexpected(Error{ErrorType::PerformError, "curl_easy_init() failed"}));
+				continue;
+			}
+		} else {
+			transfer->Handle = mIdleHandles.back();
+			mIdleHandles.pop_back();
+			curl_easy_reset(transfer->Handle);
+		}
+
+		if (auto res = setup(*transfer); !res) {
+			recordOutcome(transfer->Element.Host, Outcome::Unknown);
+			releaseTransfer(*transfer);
+			dispatch(transfer->Element, std::unexpected(res.error()));
+			continue;
+		}
+		if (auto res = curl_multi_add_handle(mMultiHandle, transfer->Handle); res != CURLM_OK) {
+			recordOutcome(transfer->Element.Host, Outcome::Unknown);
+			releaseTransfer(*transfer);
+			dispatch(transfer->Element, std::unexpected(Error{ErrorType::PerformError, curl_multi_strerror(res)}));
+			continue;
+		}
+		mTransfers.emplace_back(std::move(transfer));
+	}
+}
+
+size_t ArcdpsExtension::SimpleNetworkStack::finishTransfers() {
+	size_t finished = 0;
+	int messagesLeft = 0;
+	while (CURLMsg* message = curl_multi_info_read(mMultiHandle, &messagesLeft)) {
+		if (message->msg != CURLMSG_DONE) {
+			continue;
+		}
+		// `message` is invalid after the handle is removed
+		CURL* handle = message->easy_handle;
+		const CURLcode code = message->data.result;
+		curl_multi_remove_handle(mMultiHandle, handle);
+
+		auto it = std::ranges::find_if(mTransfers, [handle](const auto& pTransfer) { return pTransfer->Handle == handle; });
+		if (it == mTransfers.end()) {
+			continue;
+		}
+		std::unique_ptr<Transfer> transfer = std::move(*it);
+		mTransfers.erase(it);
+		++finished;
+
+		long responseCode = 0;
+		std::optional<TransferTiming> timing;
+		if (code == CURLE_OK) {
+			curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
+			timing = readTiming(handle);
+			recordTiming(transfer->Element.Host, *timing);
+		}
+		releaseTransfer(*transfer);
+
+		const bool cancelled = code == CURLE_ABORTED_BY_CALLBACK || (code != CURLE_OK && abandoned(transfer->Element));
+		if (cancelled) {
+			recordOutcome(transfer->Element.Host, Outcome::Unknown);
+		} else {
+			if (responseCode == 429 || responseCode == 503) {
+				pauseHost(transfer->Element.Host, transfer->ResponseHeaders);
+			}
+			const bool failed = transientFailure(code, responseCode);
+			// too many requests means the host is up, it doesn't count against the circuit breaker
+			recordOutcome(transfer->Element.Host, failed && responseCode != 429 ? Outcome::Failure : Outcome::Success);
+			if (failed && scheduleRetry(transfer->Element)) {
+				continue;
+			}
+		}
+
+		if (cancelled) {
+			dispatch(transfer->Element, std::unexpected(Error{ErrorType::Cancelled, "Request was cancelled"}));
+		} else if (code == CURLE_OK) {
+			auto response = complete(*transfer, responseCode);
+			if (!response) {
+				// ask again without validators, right away and with its own token
+				transfer->Element.Unconditional = true;
+				transfer->Element.Scheduled = false;
+				mDelayed.emplace_back(std::chrono::steady_clock::now(), std::move(transfer->Element));
+				continue;
+			}
+			response->Timing = timing;
+			dispatch(transfer->Element, std::move(*response));
+		} else {
+			dispatch(transfer->Element, std::unexpected(Error{ErrorType::PerformError, curl_easy_strerror(code)}));
+		}
+	}
+	return finished;
+}
+
+void ArcdpsExtension::SimpleNetworkStack::releaseTransfer(Transfer& pTransfer) {
+	if (pTransfer.File != nullptr) {
+		fclose(pTransfer.File);
+		pTransfer.File = nullptr;
+	}
+	if (pTransfer.RequestHeaders != nullptr) {
+		curl_slist_free_all(pTransfer.RequestHeaders);
+		pTransfer.RequestHeaders = nullptr;
+	}
+	if (pTransfer.Handle != nullptr) {
+		// keep the handle, so the next transfer can reuse its buffers
+		mIdleHandles.emplace_back(pTransfer.Handle);
+		pTransfer.Handle = nullptr;
+	}
+}
+
+void ArcdpsExtension::SimpleNetworkStack::runner(const std::stop_token& pToken) {
+	while (!pToken.stop_requested()) {
+		promoteDelayed();
+		startTransfers();
+		const auto retry = nextDelayed();
+
+		if (mTransfers.empty()) {
+			std::unique_lock lock(mQueueMutex);
+
+			// wait until something is queued or the next retry is due
+			if (retry) {
+				mQueueCv.wait_until(lock, pToken, *retry, [this]() {
+					return !queuesEmpty();
+				});
+			} else {
+				mQueueCv.wait(lock, pToken, [this]() {
+					return !queuesEmpty();
+				});
+			}
+			continue;
+		}
+
+		int running = 0;
+		if (auto res = curl_multi_perform(mMultiHandle, &running); res != CURLM_OK) {
+			std::cout << "curl_multi_perform() failed: " << curl_multi_strerror(res) << std::endl;
+		}
+		// free slots are filled right away, instead of waiting for the next socket activity
+		if (finishTransfers() == 0 && running > 0) {
+			int timeout = 1000;
+			if (retry) {
+				const auto untilRetry = std::chrono::ceil<std::chrono::milliseconds>(*retry - std::chrono::steady_clock::now()).count();
+				timeout = static_cast<int>(std::clamp<int64_t>(untilRetry, 0, timeout));
+			}
+			// returns early on socket activity or `curl_multi_wakeup`
+			curl_multi_poll(mMultiHandle, nullptr, 0, timeout, nullptr);
+		}
+	}
+
+	// abort everything that is still running, like the queued jobs, they are not resolved
+	for (auto& transfer : mTransfers) {
+		curl_multi_remove_handle(mMultiHandle, transfer->Handle);
+		releaseTransfer(*transfer);
+	}
+	mTransfers.clear();
+	for (CURL* handle : mIdleHandles) {
+		curl_easy_cleanup(handle);
+	}
+	mIdleHandles.clear();
+}
+
+ArcdpsExtension::SimpleNetworkStack::RequestHandle ArcdpsExtension::SimpleNetworkStack::enqueue(QueueElement pElement) {
+	RequestHandle handle(pElement.Cancelled);
+	pElement.Host = GetHost(pElement.Url);
+	{
+		std::lock_guard lock(mQueueMutex);
+		const auto key = pElement.Key();
+		auto [it, inserted] = key.empty() ? std::pair(mFollowers.end(), true) : mFollowers.try_emplace(key);
+		if (!inserted) {
+			// the same request is already queued or running, wait for its result.
+			// if it is still queued with a lower priority, it is moved up to ours
+			for (size_t prio = static_cast<size_t>(pElement.Prio) + 1; prio < PriorityCount; ++prio) {
+				auto& queue = mJobQueues[prio];
+				auto queued = std::ranges::find_if(queue, [&key](const QueueElement& pQueued) { return pQueued.Key() == key; });
+				if (queued != queue.end()) {
+					queued->Prio = pElement.Prio;
+					mJobQueues[static_cast<size_t>(pElement.Prio)].emplace_back(std::move(*queued));
+					queue.erase(queued);
+					break;
+				}
+			}
+			it->second.emplace_back(std::move(pElement));
+			return handle;
+		}
+		mJobQueues[static_cast<size_t>(pElement.Prio)].emplace_back(std::move(pElement));
+	}
 
 	mQueueCv.notify_one();
+	curl_multi_wakeup(mMultiHandle);
+	return handle;
+}
+
+ArcdpsExtension::SimpleNetworkStack::RequestHandle ArcdpsExtension::SimpleNetworkStack::QueueGet(const std::string& pUrl, const std::filesystem::path& pFilepath, Priority pPriority) {
+	return enqueue(QueueElement(pUrl, std::monostate(), pFilepath, pPriority));
+}
+ArcdpsExtension::SimpleNetworkStack::RequestHandle ArcdpsExtension::SimpleNetworkStack::QueueGet(const std::string& pUrl, const SimpleNetworkStack::ResultFunc& pFunc, const std::filesystem::path& pFilepath, Priority pPriority) {
+	return enqueue(QueueElement(pUrl, pFunc, pFilepath, pPriority));
+}
+ArcdpsExtension::SimpleNetworkStack::RequestHandle ArcdpsExtension::SimpleNetworkStack::QueueGet(const std::string& pUrl, std::promise<Result> pPromise, const std::filesystem::path& pFilepath, Priority pPriority) {
+	return enqueue(QueueElement(pUrl, std::move(pPromise), pFilepath, pPriority));
+}
+ArcdpsExtension::SimpleNetworkStack::RequestHandle ArcdpsExtension::SimpleNetworkStack::QueueStream(const std::string& pUrl, ChunkFunc pSink, const ResultFunc& pFunc, Priority pPriority) {
+	QueueElement element(pUrl, pFunc, "", pPriority);
+	element.Sink = std::move(pSink);
+	return enqueue(std::move(element));
+}
+ArcdpsExtension::SimpleNetworkStack::RequestHandle ArcdpsExtension::SimpleNetworkStack::QueueStream(const std::string& pUrl, ChunkFunc pSink, ResultPromise pPromise, Priority pPriority) {
+	QueueElement element(pUrl, std::move(pPromise), "", pPriority);
+	element.Sink = std::move(pSink);
+	return enqueue(std::move(element));
+}
+void ArcdpsExtension::SimpleNetworkStack::GetAwaiter::await_suspend(std::coroutine_handle<> pHandle) {
+	// the callback can resume the coroutine before `QueueGet` returns, `this` must not be used afterward
+	mNetworkStack.QueueGet(
+			mUrl,
+			[this, pHandle](const Result& pResult) {
+				mResult = pResult;
+				if (mExecutor) {
+					mExecutor->Post(pHandle);
+				} else {
+					pHandle.resume();
+				}
+			},
+			mFilepath,
+			mPriority
+	);
 }
 std::string ArcdpsExtension::SimpleNetworkStack::UrlEncode(std::string_view pStr) const {
-	const char* escaped = curl_easy_escape(mHandle, pStr.data(), pStr.length());
+	char* escaped = curl_easy_escape(mHandle, pStr.data(), static_cast<int>(pStr.length()));
 	if (escaped != nullptr) {
-		return escaped;
+		std::string result = escaped;
+		curl_free(escaped);
+		return result;
 	}
 	return "";
 }
@@ -1,33 +1,88 @@
 #pragma once
 
+#include "Coroutine.h"
+#include "HttpCache.h"
+#include "QuantileSketch.h"
 #include "Singleton.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <coroutine>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <curl/curl.h>
+#include <deque>
 #include <expected>
 #include <filesystem>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
+#include <random>
 #include <stop_token>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 namespace ArcdpsExtension {
+	/**
+	 * All requests are performed by one thread with the curl multi interface,
+	 * so up to `SetMaxConcurrentTransfers()` requests are in flight at the same time.
+	 * Callbacks and promises are resolved on that thread.
+	 * <br>
+	 * Identical requests (same URL and same filepath) that are queued while another one is still queued or running,
+	 * are not performed again. They get the result of the first one.
+	 * <br>
+	 * Queued requests are started by `Priority`, requests with the same priority in the order they were queued.
+	 * Every `QueueGet` returns a `RequestHandle`, to cancel the request or ask for its position in the queue.
+	 * <br>
+	 * Transient failures (connection errors, timeouts, 408, 429, 500, 502, 503, 504) are retried with exponential backoff (see `RetryPolicy`).
+	 * A host that fails too often in a row is considered down, requests to it fail right away for a while (see `CircuitBreakerPolicy`).
+	 * <br>
+	 * Hosts can be rate limited with `SetRateLimit`, requests over the limit are delayed, not failed.
+	 * `429 Too Many Requests` and `503` with `Retry-After` pause all requests to that host for the given time, the request is retried afterwards.
+	 * <br>
+	 * Connections stay open between transfers, so a later request to the same host usually doesn't connect again.
+	 * TLS sessions are shared by all transfers, a new connection to a known host can resume the session instead of a full handshake.
+	 * HTTP/2 multiplexing is used where the server offers it over TLS.
+	 */
 	class SimpleNetworkStack final : public Singleton<SimpleNetworkStack> {
 	public:
 		SimpleNetworkStack();
 		~SimpleNetworkStack() override;
 
+		/**
+		 * Timing of a single transfer, as measured by curl.
+		 * All times are in milliseconds since the start of the transfer, so the phase durations are differences:
+		 * `StartTransfer - AppConnect` is the server latency, for example.
+		 * Skipped phases are 0, like `Connect` and `AppConnect` on a reused connection.
+		 */
+		struct TransferTiming {
+			double NameLookup = 0;    // DNS done
+			double Connect = 0;       // TCP connected
+			double AppConnect = 0;    // TLS handshake done, 0 for plain HTTP
+			double StartTransfer = 0; // first byte received
+			double Total = 0;
+			uint64_t Size = 0; // downloaded bytes of the body
+			double Speed = 0;  // average download speed in bytes per second
+		};
+
 		struct Response {
 			std::string Message;
 			long Code;
+			// served from the response cache, without downloading the body again
+			bool Cached = false;
+			// not set for responses served from the cache without network access
+			std::optional<TransferTiming> Timing{};
 		};
 		enum class ErrorType {
 			PerformError,
@@ -36,6 +91,8 @@ namespace ArcdpsExtension {
 			OptWriteFuncError,
 			OptWriteDataError,
 			OptUseragentError,
+			Cancelled,
+			CircuitOpen,
 		};
 		struct Error {
 			ErrorType Type;
@@ -44,6 +101,134 @@ namespace ArcdpsExtension {
 		using Result = std::expected<Response, Error>;
 		using ResultFunc = std::function<void(const Result&)>;
 		using ResultPromise = std::promise<Result>;
+		// gets the body in chunks as they arrive, return `false` to abort the transfer
+		using ChunkFunc = std::function<bool(std::string_view pChunk)>;
+
+		enum class Priority : uint8_t {
+			High,   // user triggered, like an update check
+			Normal,
+			Low,    // background prefetching
+		};
+		static constexpr size_t PriorityCount = 3;
+
+		/**
+		 * Returned by `QueueGet`, to cancel the request or look it up in the queue.
+		 * Cheap to copy, all copies refer to the same request.
+		 * <br>
+		 * A cancelled request is dropped before its transfer starts, or aborted while it is running.
+		 * Its `ResultFunc` is not called anymore, so it is safe to cancel in the destructor of the object the callback refers to.
+		 * Its `ResultPromise` is resolved with `ErrorType::Cancelled`.
+		 * Callbacks that are already running are not interrupted.
+		 */
+		class RequestHandle {
+		public:
+			RequestHandle() = default;
+
+			void Cancel() {
+				if (mCancelled) {
+					mCancelled->store(true, std::memory_order_relaxed);
+				}
+			}
+
+			[[nodiscard]] bool Cancelled() const {
+				return mCancelled && mCancelled->load(std::memory_order_relaxed);
+			}
+
+			/**
+			 * @return `false` if default constructed.
+			 */
+			[[nodiscard]] bool Valid() const {
+				return mCancelled != nullptr;
+			}
+
+		private:
+			friend class SimpleNetworkStack;
+
+			explicit RequestHandle(std::shared_ptr<std::atomic_bool> pCancelled) : mCancelled(std::move(pCancelled)) {}
+
+			std::shared_ptr<std::atomic_bool> mCancelled;
+		};
+
+		/**
+		 * Awaitable of `Get`, resolves to the `Result` of the request.
+		 */
+		class GetAwaiter {
+		public:
+			GetAwaiter(SimpleNetworkStack& pNetworkStack, std::string pUrl, Executor* pExecutor, std::filesystem::path pFilepath, Priority pPriority)
+				: mNetworkStack(pNetworkStack), mUrl(std::move(pUrl)), mExecutor(pExecutor), mFilepath(std::move(pFilepath)), mPriority(pPriority) {}
+
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> pHandle);
+			Result await_resume() { return std::move(*mResult); }
+
+		private:
+			SimpleNetworkStack& mNetworkStack;
+			std::string mUrl;
+			Executor* mExecutor;
+			std::filesystem::path mFilepath;
+			Priority mPriority;
+			std::optional<Result> mResult;
+		};
+
+		struct RetryPolicy {
+			// including the first attempt, 1 disables retries
+			uint32_t MaxAttempts = 3;
+			// delay before the first retry, doubled for every further one
+			std::chrono::milliseconds BaseDelay{500};
+			std::chrono::milliseconds MaxDelay{10000};
+			// up to this fraction of the delay is randomly left out, so clients don't retry in lockstep
+			double Jitter = 0.5;
+		};
+
+		struct CircuitBreakerPolicy {
+			// failures in a row until a host is considered down, 0 disables the circuit breaker
+			uint32_t FailureThreshold = 5;
+			// how long requests fail right away, before a single trial request is let through
+			std::chrono::milliseconds OpenDuration{30000};
+		};
+
+		enum class CircuitState {
+			Closed,   // host is fine
+			Open,     // host is down, requests fail with `ErrorType::CircuitOpen`
+			HalfOpen, // a trial request decides if the host is up again
+		};
+
+		struct RateLimit {
+			// tokens refilled per second, 0 means unlimited
+			double RequestsPerSecond = 0;
+			// size of the bucket, how many requests can be sent at once after a pause
+			double Burst = 1;
+		};
+
+		struct BucketState {
+			RateLimit Limit;
+			// can be negative, when requests are already scheduled for the future
+			double Tokens = 0;
+			// time left of a pause from `Retry-After`
+			std::chrono::milliseconds BlockedFor{0};
+		};
+
+		/**
+		 * Distribution of the `TransferTiming`s of all finished transfers to a host, failed attempts included.
+		 * Times are in milliseconds, `Speed` in bytes per second.
+		 */
+		struct HostTimings {
+			QuantileSketch NameLookup;
+			QuantileSketch Connect;
+			QuantileSketch AppConnect;
+			QuantileSketch StartTransfer;
+			QuantileSketch Total;
+			QuantileSketch Speed;
+			uint64_t Bytes = 0;
+
+			void Add(const TransferTiming& pTiming);
+		};
+
+		struct CacheStats {
+			uint64_t Hits = 0;          // fresh entry served without network access
+			uint64_t Misses = 0;        // body downloaded
+			uint64_t Revalidations = 0; // stale entry confirmed by the server (304)
+		};
 
 		/**
 	     * Performs a Get-Request.
@@ -59,8 +244,10 @@ namespace ArcdpsExtension {
 	     *
 	     * @param pUrl The URL to call
 	     * @param pFilepath Optional filepath to save the response to
+	     * @param pPriority Requests with higher priority are started first
+	     * @return Handle to cancel the request
 	     */
-		void QueueGet(const std::string& pUrl, const std::filesystem::path& pFilepath = "");
+		RequestHandle QueueGet(const std::string& pUrl, const std::filesystem::path& pFilepath = "", Priority pPriority = Priority::Normal);
 
 		/**
 	     * Performs a Get-Request and will call pFunc when the response is gathered.
@@ -78,8 +265,10 @@ namespace ArcdpsExtension {
 	     * @param pUrl The URL to call
 	     * @param pFunc The function that will be called with the response
 	     * @param pFilepath Optional filepath to save the response to
+	     * @param pPriority Requests with higher priority are started first
+	     * @return Handle to cancel the request
 	     */
-		void QueueGet(const std::string& pUrl, const ResultFunc& pFunc, const std::filesystem::path& pFilepath = "");
+		RequestHandle QueueGet(const std::string& pUrl, const ResultFunc& pFunc, const std::filesystem::path& pFilepath = "", Priority pPriority = Priority::Normal);
 
 		/**
 	     * Performs a Get-Request and will resolve the promise when the response is gathered.
@@ -95,8 +284,82 @@ namespace ArcdpsExtension {
 	     * @param pUrl The URL to call
 	     * @param pPromise Promise that will resolved with the response
 	     * @param pFilepath Optional filepath to save the response to
+	     * @param pPriority Requests with higher priority are started first
+	     * @return Handle to cancel the request
 	     */
-		void QueueGet(const std::string& pUrl, ResultPromise pPromise, const std::filesystem::path& pFilepath = "");
+		RequestHandle QueueGet(const std::string& pUrl, ResultPromise pPromise, const std::filesystem::path& pFilepath = "", Priority pPriority = Priority::Normal);
+
+		/**
+		 * Performs a Get-Request and passes the body to `pSink` in chunks, as they arrive, instead of collecting it.
+		 * Meant for large responses, that are parsed, hashed or decoded incrementally.
+		 * `pFunc` is called at the end, its Response has an empty Message.
+		 * Both are called on the network thread.
+		 * Streamed requests are neither cached nor merged with identical ones.
+		 * If `pSink` returns `false` or throws, the transfer is aborted and `pFunc` gets a `PerformError`.
+		 * <br>
+		 * Usage:
+		 * @code
+		 * networkStack.QueueStream("https://example.com/big.json",
+		 * 	[&parser](std::string_view pChunk) {
+		 * 		return parser.Feed(pChunk);
+		 * 	},
+		 * 	[&parser](const SimpleNetworkStack::Result& pResult) {
+		 * 		if (pResult && pResult->Code == 200) parser.Finish();
+		 * 	});
+		 * @endcode
+		 *
+		 * @param pUrl The URL to call
+		 * @param pSink Called for every chunk of the body
+		 * @param pFunc Called when the transfer is done
+		 * @param pPriority Requests with higher priority are started first
+		 * @return Handle to cancel the request, `pSink` is not called anymore afterward
+		 */
+		RequestHandle QueueStream(const std::string& pUrl, ChunkFunc pSink, const ResultFunc& pFunc, Priority pPriority = Priority::Normal);
+
+		/**
+		 * Same as the other `QueueStream`, but resolves `pPromise` when the transfer is done.
+		 */
+		RequestHandle QueueStream(const std::string& pUrl, ChunkFunc pSink, ResultPromise pPromise, Priority pPriority = Priority::Normal);
+
+		/**
+		 * Performs a Get-Request from a coroutine, the coroutine is suspended until the response is gathered.
+		 * No thread is blocked while waiting, unlike with `future.get()`.
+		 * Same as `QueueGet` otherwise: cached, merged with identical requests and retried.
+		 * The request is queued when it is awaited, not when `Get` is called.
+		 * <br>
+		 * If the network stack is destroyed before the request is done, the coroutine is never resumed.
+		 * <br>
+		 * Usage:
+		 * @code
+		 * Task<> LoadIcon(QueueExecutor& pIconThread, std::string pUrl, std::filesystem::path pPath) {
+		 * 	auto response = co_await SimpleNetworkStack::instance().Get(pUrl, &pIconThread, pPath);
+		 * 	if (response && response->Code == 200) {
+		 * 		// runs on the thread that runs `pIconThread`
+		 * 		LoadFile(pPath);
+		 * 	}
+		 * }
+		 * @endcode
+		 *
+		 * @param pUrl The URL to call
+		 * @param pExecutor Where the coroutine continues, `nullptr` continues on the network thread
+		 * @param pFilepath Optional filepath to save the response to
+		 * @param pPriority Requests with higher priority are started first
+		 */
+		[[nodiscard]] GetAwaiter Get(std::string pUrl, Executor* pExecutor = nullptr, std::filesystem::path pFilepath = "", Priority pPriority = Priority::Normal) {
+			return GetAwaiter(*this, std::move(pUrl), pExecutor, std::move(pFilepath), pPriority);
+		}
+
+		/**
+		 * Position of a request in the queue, cancelled requests are not counted.
+		 * Only a snapshot, the runner thread starts requests any time.
+		 * @return 0 for the next request to start, `std::nullopt` if the request is running, done or cancelled.
+		 */
+		[[nodiscard]] std::optional<size_t> QueuePosition(const RequestHandle& pHandle) const;
+
+		/**
+		 * @return Number of queued requests that are not running yet, including cancelled ones that were not dropped yet.
+		 */
+		[[nodiscard]] size_t QueueSize() const;
 
 		/**
 		 * Set a different user-agent instead of the default "ArcdpsExtension/1.0"
@@ -106,6 +369,101 @@ namespace ArcdpsExtension {
 			mUserAgent = pUserAgent;
 		}
 
+		/**
+		 * Set how many requests are performed at the same time, the default is 8.
+		 * Already running transfers are not aborted, when the limit is lowered.
+		 * @param pMaxTransfers new limit, at least 1
+		 */
+		void SetMaxConcurrentTransfers(size_t pMaxTransfers);
+
+		[[nodiscard]] size_t GetMaxConcurrentTransfers() const {
+			return mMaxTransfers.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * Enable the on-disk response cache (see `HttpCache`), it is disabled by default.
+		 * Fresh entries are served without network access, stale ones are revalidated with `If-None-Match`/`If-Modified-Since`.
+		 * Applies to requests that are started after this call.
+		 * <br>
+		 * Usage:
+		 * @code
+		 * networkStack.SetCacheDirectory(std::filesystem::temp_directory_path() / "GW2-arcdps-extension" / "http-cache");
+		 * @endcode
+		 *
+		 * @param pDirectory Directory for the cache files, an empty path disables the cache
+		 */
+		void SetCacheDirectory(const std::filesystem::path& pDirectory);
+
+		[[nodiscard]] CacheStats GetCacheStats() const;
+
+		/**
+		 * Applies to failures that happen after this call. Streamed requests are never retried,
+		 * their sink already got parts of the body.
+		 */
+		void SetRetryPolicy(const RetryPolicy& pPolicy);
+
+		[[nodiscard]] RetryPolicy GetRetryPolicy() const;
+
+		void SetCircuitBreakerPolicy(const CircuitBreakerPolicy& pPolicy);
+
+		[[nodiscard]] CircuitBreakerPolicy GetCircuitBreakerPolicy() const;
+
+		/**
+		 * @param pHost Host as returned by `GetHost`
+		 */
+		[[nodiscard]] CircuitState GetCircuitState(const std::string& pHost) const;
+
+		/**
+		 * Limit the request rate to a host with a token bucket.
+		 * Every request takes one token, requests without token wait until one is refilled.
+		 * Requests to other hosts are not held up by them.
+		 * <br>
+		 * Usage:
+		 * @code
+		 * // GW2 API allows bursts of 300 requests, refilled with 5 per second
+		 * networkStack.SetRateLimit("api.guildwars2.com", {.RequestsPerSecond = 5, .Burst = 300});
+		 * @endcode
+		 *
+		 * @param pHost Host as returned by `GetHost`
+		 * @param pLimit New limit, the bucket starts full
+		 */
+		void SetRateLimit(const std::string& pHost, const RateLimit& pLimit);
+
+		void RemoveRateLimit(const std::string& pHost);
+
+		/**
+		 * @return State of the bucket of `pHost`, `std::nullopt` if the host is neither limited nor paused.
+		 */
+		[[nodiscard]] std::optional<BucketState> GetBucketState(const std::string& pHost) const;
+
+		/**
+		 * Timing statistics of a host, to see whether slow requests are caused by DNS, TLS, the server or the bandwidth.
+		 * <br>
+		 * Usage:
+		 * @code
+		 * if (auto timings = networkStack.GetTimings("render.guildwars2.com")) {
+		 * 	double p95FirstByte = timings->StartTransfer.Quantile(0.95);
+		 * 	double medianSpeed = timings->Speed.Quantile(0.5);
+		 * }
+		 * @endcode
+		 *
+		 * @param pHost Host as returned by `GetHost`
+		 * @return Copy of the statistics, `std::nullopt` if no transfer to the host finished yet.
+		 */
+		[[nodiscard]] std::optional<HostTimings> GetTimings(const std::string& pHost) const;
+
+		/**
+		 * @return Copy of the statistics of all hosts.
+		 */
+		[[nodiscard]] std::unordered_map<std::string, HostTimings> GetAllTimings() const;
+
+		void ResetTimings();
+
+		/**
+		 * @return The host part of `pUrl`, or an empty string, if the URL cannot be parsed.
+		 */
+		[[nodiscard]] static std::string GetHost(const std::string& pUrl);
+
 		/**
 		 * URL encode a string. Wrapper for `curl_easy_escape`.
 		 * @param pStr string to encode
@@ -120,29 +478,145 @@ namespace ArcdpsExtension {
 			Variant Callback;
 			// only set this when a download should take place
 			std::filesystem::path Filepath;
+			Priority Prio = Priority::Normal;
+			std::shared_ptr<std::atomic_bool> Cancelled = std::make_shared<std::atomic_bool>(false);
+			// only set for `QueueStream`
+			ChunkFunc Sink;
+			std::string Host;
+			// failed attempts so far
+			uint32_t Attempts = 0;
+			// already got its slot from the rate limiter
+			bool Scheduled = false;
+			// send without validators, the cached body is gone
+			bool Unconditional = false;
 
-			QueueElement(std::string pUrl, Variant pCallback, std::filesystem::path pFilepath) : Url(std::move(pUrl)), Callback(std::move(pCallback)), Filepath(std::move(pFilepath)) {}
+			QueueElement(std::string pUrl, Variant pCallback, std::filesystem::path pFilepath, Priority pPriority)
+				: Url(std::move(pUrl)), Callback(std::move(pCallback)), Filepath(std::move(pFilepath)), Prio(pPriority) {}
 			~QueueElement() = default;
 
+			// identical requests have the same key, streams are never identical and have an empty key
+			[[nodiscard]] std::string Key() const {
+				if (Sink) {
+					return "";
+				}
+				return Url + '\n' + Filepath.string();
+			}
+
 			QueueElement(const QueueElement&) = delete;
 			QueueElement(QueueElement&& pOther) noexcept = default;
 			QueueElement& operator=(const QueueElement&) = delete;
 			QueueElement& operator=(QueueElement&& pOther) noexcept = default;
 		};
 
+		// one running request, only touched by the runner thread
+		struct Transfer {
+			QueueElement Element;
+			CURL* Handle = nullptr;
+			std::string Buffer;
+			FILE* File = nullptr;
+			curl_slist* RequestHeaders = nullptr;
+			HttpCache::Headers ResponseHeaders;
+			std::shared_ptr<HttpCache> Cache;
+			// the entry to revalidate
+			std::optional<HttpCache::Entry> CachedEntry;
+			SimpleNetworkStack* Owner = nullptr;
+
+			Transfer(QueueElement pElement, SimpleNetworkStack* pOwner) : Element(std::move(pElement)), Owner(pOwner) {}
+		};
+
+		// upper limit for the buffer that is reserved up front from Content-Length
+		static constexpr uint64_t MaxReservedBodySize = 16 * 1024 * 1024;
+
+		// only used for `UrlEncode`
 		CURL* mHandle = nullptr;
-		std::string mLastResponseBuffer;
-		long mLastResponseCode = 0;
+		CURLM* mMultiHandle = nullptr;
+		CURLSH* mShareHandle = nullptr;
+		// owned by the runner thread
+		std::vector<std::unique_ptr<Transfer>> mTransfers;
+		std::vector<CURL*> mIdleHandles;
+		std::atomic_size_t mMaxTransfers = 8;
+
+		// guarded by `mQueueMutex`
+		std::shared_ptr<HttpCache> mCache;
+		std::atomic_uint64_t mCacheHits = 0;
+		std::atomic_uint64_t mCacheMisses = 0;
+		std::atomic_uint64_t mCacheRevalidations = 0;
 
 		std::jthread mThread;
-		std::queue<QueueElement> mJobQueue;
-		std::mutex mQueueMutex;
+		// one FIFO queue per priority
+		std::array<std::deque<QueueElement>, PriorityCount> mJobQueues;
+		// requests that were merged into a queued or running one, by `QueueElement::Key()`.
+		// every queued or running request has an entry here, guarded by `mQueueMutex`
+		std::unordered_map<std::string, std::vector<QueueElement>> mFollowers;
+		mutable std::mutex mQueueMutex;
+
+		struct Bucket {
+			RateLimit Limit;
+			double Tokens = 0;
+			std::chrono::steady_clock::time_point LastRefill;
+			std::chrono::steady_clock::time_point BlockedUntil;
+
+			// only held a pause from `Retry-After`, which is over
+			[[nodiscard]] bool Expired(std::chrono::steady_clock::time_point pNow) const {
+				return Limit.RequestsPerSecond <= 0 && BlockedUntil <= pNow;
+			}
+		};
+
+		struct Circuit {
+			uint32_t Failures = 0; // in a row
+			std::chrono::steady_clock::time_point OpenUntil;
+			bool TrialRunning = false;
+		};
+
+		// requests waiting for their next attempt or for the rate limiter, owned by the runner thread
+		std::vector<std::pair<std::chrono::steady_clock::time_point, QueueElement>> mDelayed;
+		std::mt19937 mRandom{std::random_device{}()};
+		// guarded by `mHostMutex`
+		RetryPolicy mRetryPolicy;
+		CircuitBreakerPolicy mCircuitBreakerPolicy;
+		std::unordered_map<std::string, Circuit> mCircuits;
+		std::unordered_map<std::string, Bucket> mBuckets;
+		std::unordered_map<std::string, HostTimings> mTimings;
+		mutable std::mutex mHostMutex;
 		std::condition_variable_any mQueueCv;
 
 		std::string mUserAgent = "ArcdpsExtension/1.0";
 
 		static size_t ResponseBufferWriteFunction(void* pContent, size_t pSize, size_t pNMemb, void* pUserP);
-		SimpleNetworkStack::Result get(const QueueElement& pElement);
+		static size_t StreamWriteFunction(void* pContent, size_t pSize, size_t pNMemb, void* pUserP);
+		static size_t HeaderFunction(char* pBuffer, size_t pSize, size_t pNItems, void* pUserData);
+		std::optional<Response> loadCached(Transfer& pTransfer);
+		// empty if a 304 arrived but the cached body is gone, the request has to be sent again
+		std::optional<Response> complete(Transfer& pTransfer, long pCode);
+		std::expected<void, Error> setup(Transfer& pTransfer);
+		void startTransfers();
+		size_t finishTransfers();
+		void releaseTransfer(Transfer& pTransfer);
+		static int ProgressFunction(void* pClientP, curl_off_t pDlTotal, curl_off_t pDlNow, curl_off_t pUlTotal, curl_off_t pUlNow);
+		RequestHandle enqueue(QueueElement pElement);
+		[[nodiscard]] bool queuesEmpty() const;
+		// `mQueueMutex` has to be locked
+		[[nodiscard]] bool cancelled(const QueueElement& pElement) const;
+		// same as `cancelled`, locks `mQueueMutex` itself
+		[[nodiscard]] bool abandoned(const QueueElement& pElement) const;
+		[[nodiscard]] static bool transientFailure(CURLcode pCode, long pResponseCode);
+		bool scheduleRetry(QueueElement& pElement);
+		void promoteDelayed();
+		[[nodiscard]] std::optional<std::chrono::steady_clock::time_point> nextDelayed() const;
+		enum class Outcome {
+			Success,
+			Failure,
+			Unknown, // cancelled, only ends a trial request
+		};
+		bool allowRequest(const std::string& pHost);
+		[[nodiscard]] std::optional<std::chrono::steady_clock::time_point> acquireToken(const std::string& pHost);
+		void pauseHost(const std::string& pHost, const HttpCache::Headers& pHeaders);
+		void recordOutcome(const std::string& pHost, Outcome pOutcome);
+		[[nodiscard]] static TransferTiming readTiming(CURL* pHandle);
+		void recordTiming(const std::string& pHost, const TransferTiming& pTiming);
+		void dispatch(QueueElement& pElement, Result pResult);
+		// moves the result into a promise, if `pLast`
+		static void resolve(QueueElement& pElement, Result& pResult, bool pLast);
 		void runner(const std::stop_token& pToken);
 	};
 } // namespace ArcdpsExtension
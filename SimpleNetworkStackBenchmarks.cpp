@@ -0,0 +1,55 @@
+#include "SimpleNetworkStack.h"
+#include "test/LocalHttpServer.h"
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <future>
+#include <string>
+#include <vector>
+
+using namespace ArcdpsExtension;
+using namespace ArcdpsExtension::Test;
+
+namespace {
+	constexpr int64_t RequestsPerIteration = 64;
+	constexpr size_t BodySize = 16 * 1024;
+
+	/**
+	 * `pState.range(0)` is the concurrency limit, `pState.range(1)` the server latency in ms.
+	 * Every iteration requests a batch of icon sized files and waits for all of them.
+	 */
+	void Throughput(benchmark::State& pState) {
+		const std::chrono::milliseconds latency(pState.range(1));
+		const std::string body(BodySize, 'x');
+		LocalHttpServer server([&](const HttpRequest&) {
+			return HttpReply{.Body = body, .Delay = latency};
+		});
+
+		SimpleNetworkStack networkStack;
+		networkStack.SetMaxConcurrentTransfers(static_cast<size_t>(pState.range(0)));
+
+		for (auto _ : pState) {
+			std::vector<std::future<SimpleNetworkStack::Result>> futures;
+			futures.reserve(RequestsPerIteration);
+			for (int64_t i = 0; i < RequestsPerIteration; ++i) {
+				std::promise<SimpleNetworkStack::Result> promise;
+				futures.emplace_back(promise.get_future());
+				networkStack.QueueGet(server.Url(std::format("/icon/{}.png", i)), std::move(promise));
+			}
+			for (auto& future : futures) {
+				auto result = future.get();
+				if (!result || result->Code != 200) {
+					pState.SkipWithError("request failed");
+					return;
+				}
+				benchmark::DoNotOptimize(result);
+			}
+		}
+		pState.SetItemsProcessed(pState.iterations() * RequestsPerIteration);
+		pState.SetBytesProcessed(pState.iterations() * RequestsPerIteration * static_cast<int64_t>(BodySize));
+	}
+} // namespace
+
+BENCHMARK(Throughput)->ArgsProduct({{1, 4, 16}, {0, 20}})->ArgNames({"concurrency", "latency_ms"})->UseRealTime()->Unit(benchmark::kMillisecond);
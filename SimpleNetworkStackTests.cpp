@@ -1,15 +1,27 @@
 #include "SimpleNetworkStack.h"
 
+#include "Coroutine.h"
 #include "Singleton.h"
+#include "test/LocalHttpServer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <expected>
 #include <filesystem>
+#include <format>
 #include <future>
 #include <gtest/gtest.h>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 using namespace ArcdpsExtension;
+using namespace ArcdpsExtension::Test;
 
 namespace {
 	const std::filesystem::path TEMPFILE = std::filesystem::temp_directory_path() / "out.tmp";
@@ -106,3 +118,753 @@ TEST_F(SimpleNetworkStackTests, UrlEncode) {
 
 	ASSERT_EQ(encodedStr, "%C3%A4%C3%B6%C3%BC%C3%9F-%3A%2C");
 }
+
+TEST_F(SimpleNetworkStackTests, ConcurrentTransfers) {
+	std::atomic_int active = 0;
+	std::atomic_int peak = 0;
+	LocalHttpServer server([&](const HttpRequest& pRequest) {
+		const int now = ++active;
+		int expected = peak.load();
+		while (now > expected && !peak.compare_exchange_weak(expected, now)) {}
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		--active;
+		return HttpReply{200, pRequest.Target};
+	});
+
+	SimpleNetworkStack networkStack;
+	networkStack.SetMaxConcurrentTransfers(4);
+
+	std::vector<std::future<SimpleNetworkStack::Result>> futures;
+	for (int i = 0; i < 12; ++i) {
+		std::promise<SimpleNetworkStack::Result> promise;
+		futures.emplace_back(promise.get_future());
+		networkStack.QueueGet(server.Url(std::format("/{}", i)), std::move(promise));
+	}
+
+	for (int i = 0; i < 12; ++i) {
+		auto response = futures[i].get();
+		ASSERT_TRUE(response.has_value());
+		EXPECT_EQ(response.value().Code, 200);
+		EXPECT_EQ(response.value().Message, std::format("/{}", i));
+	}
+	EXPECT_GT(peak.load(), 1);
+	EXPECT_LE(peak.load(), 4);
+	EXPECT_EQ(server.RequestCount(), 12);
+}
+
+TEST_F(SimpleNetworkStackTests, ConnectionError) {
+	SimpleNetworkStack networkStack;
+	networkStack.SetRetryPolicy({.MaxAttempts = 2, .BaseDelay = std::chrono::milliseconds(10)});
+
+	std::promise<SimpleNetworkStack::Result> promise;
+	auto future = promise.get_future();
+	// nothing listens on port 1
+	networkStack.QueueGet("http://127.0.0.1:1/", std::move(promise));
+	auto response = future.get();
+	ASSERT_FALSE(response.has_value());
+	EXPECT_EQ(response.error().Type, SimpleNetworkStack::ErrorType::PerformError);
+}
+
+TEST_F(SimpleNetworkStackTests, CacheHitAndRevalidate) {
+	const auto cacheDir = std::filesystem::temp_directory_path() / "SimpleNetworkStackTestsCache";
+	std::filesystem::remove_all(cacheDir);
+
+	std::atomic_int notModified = 0;
+	LocalHttpServer server([&](const HttpRequest& pRequest) {
+		if (pRequest.Target == "/fresh") {
+			return HttpReply{200, "fresh", {{"Cache-Control", "max-age=3600"}, {"ETag", "\"f\""}}};
+		}
+		if (pRequest.Header("if-none-match") == "\"s\"") {
+			++notModified;
+			return HttpReply{304, "", {{"ETag", "\"s\""}}};
+		}
+		return HttpReply{200, "stale", {{"Cache-Control", "no-cache"}, {"ETag", "\"s\""}}};
+	});
+
+	SimpleNetworkStack networkStack;
+	networkStack.SetCacheDirectory(cacheDir);
+
+	auto get = [&](const std::string& pUrl, const std::filesystem::path& pFilepath = "") {
+		std::promise<SimpleNetworkStack::Result> promise;
+		auto future = promise.get_future();
+		networkStack.QueueGet(pUrl, std::move(promise), pFilepath);
+		return future.get();
+	};
+
+	auto first = get(server.Url("/fresh"));
+	ASSERT_TRUE(first.has_value());
+	EXPECT_FALSE(first->Cached);
+	auto second = get(server.Url("/fresh"));
+	ASSERT_TRUE(second.has_value());
+	EXPECT_TRUE(second->Cached);
+	EXPECT_EQ(second->Message, "fresh");
+	EXPECT_EQ(second->Code, 200);
+	EXPECT_EQ(server.RequestCount(), 1);
+
+	get(server.Url("/stale"));
+	auto revalidated = get(server.Url("/stale"), TEMPFILE);
+	ASSERT_TRUE(revalidated.has_value());
+	EXPECT_TRUE(revalidated->Cached);
+	EXPECT_EQ(revalidated->Code, 200);
+	EXPECT_EQ(notModified.load(), 1);
+	EXPECT_EQ(std::filesystem::file_size(TEMPFILE), 5);
+
+	const auto stats = networkStack.GetCacheStats();
+	EXPECT_EQ(stats.Hits, 1);
+	EXPECT_EQ(stats.Misses, 2);
+	EXPECT_EQ(stats.Revalidations, 1);
+
+	std::filesystem::remove_all(cacheDir);
+}
+
+TEST_F(SimpleNetworkStackTests, RevalidateLostBody) {
+	const auto cacheDir = std::filesystem::temp_directory_path() / "SimpleNetworkStackTestsCache";
+	std::filesystem::remove_all(cacheDir);
+
+	std::atomic_int notModified = 0;
+	LocalHttpServer server([&](const HttpRequest& pRequest) {
+		if (pRequest.Header("if-none-match") == "\"s\"") {
+			++notModified;
+			return HttpReply{304, "", {{"ETag", "\"s\""}}};
+		}
+		return HttpReply{200, "stale", {{"Cache-Control", "no-cache"}, {"ETag", "\"s\""}}};
+	});
+
+	SimpleNetworkStack networkStack;
+	networkStack.SetCacheDirectory(cacheDir);
+
+	auto get = [&]() {
+		std::promise<SimpleNetworkStack::Result> promise;
+		auto future = promise.get_future();
+		networkStack.QueueGet(server.Url("/stale"), std::move(promise));
+		return future.get();
+	};
+
+	ASSERT_TRUE(get().has_value());
+	for (const auto& file : std::filesystem::directory_iterator(cacheDir)) {
+		if (file.path().extension() == ".body") {
+			std::filesystem::remove(file.path());
+		}
+	}
+
+	// the 304 cannot be answered from the cache, the request is sent again without validators
+	auto response = get();
+	ASSERT_TRUE(response.has_value());
+	EXPECT_EQ(response->Code, 200);
+	EXPECT_EQ(response->Message, "stale");
+	EXPECT_FALSE(response->Cached);
+	EXPECT_EQ(notModified.load(), 1);
+	EXPECT_EQ(server.RequestCount(), 3);
+
+	std::filesystem::remove_all(cacheDir);
+}
+
+TEST_F(SimpleNetworkStackTests, CoalesceIdenticalRequests) {
+	LocalHttpServer server([](const HttpRequest& pRequest) {
+		return HttpReply{.Body = pRequest.Target, .Delay = std::chrono::milliseconds(50)};
+	});
+
+	SimpleNetworkStack networkStack;
+
+	std::atomic_int callbacks = 0;
+	std::vector<std::future<SimpleNetworkStack::Result>> futures;
+	for (int i = 0; i < 4; ++i) {
+		std::promise<SimpleNetworkStack::Result> promise;
+		futures.emplace_back(promise.get_future());
+		networkStack.QueueGet(server.Url("/same"), std::move(promise));
+		networkStack.QueueGet(server.Url("/same"), [&callbacks](const SimpleNetworkStack::Result& pResult) {
+			EXPECT_TRUE(pResult.has_value());
+			++callbacks;
+		});
+	}
+	// a different target is its own request
+	std::promise<SimpleNetworkStack::Result> download;
+	futures.emplace_back(download.get_future());
+	networkStack.QueueGet(server.Url("/same"), std::move(download), TEMPFILE);
+
+	for (auto& future : futures) {
+		auto response = future.get();
+		ASSERT_TRUE(response.has_value());
+		EXPECT_EQ(response->Code, 200);
+	}
+	EXPECT_EQ(callbacks.load(), 4);
+	EXPECT_EQ(server.RequestCount(), 2);
+
+	// finished requests are not reused
+	std::promise<SimpleNetworkStack::Result> later;
+	auto laterFuture = later.get_future();
+	networkStack.QueueGet(server.Url("/same"), std::move(later));
+	ASSERT_TRUE(laterFuture.get().has_value());
+	EXPECT_EQ(server.RequestCount(), 3);
+}
+
+namespace {
+	/**
+	 * Server where the first request of `/block` waits until `Release()`, to fill the queue behind it.
+	 */
+	class BlockingServer {
+	public:
+		BlockingServer()
+			: mServer([this](const HttpRequest& pRequest) {
+				  if (pRequest.Target == "/block") {
+					  mBlocked.set_value();
+					  mRelease.wait();
+				  } else {
+					  std::lock_guard guard(mMutex);
+					  mOrder.emplace_back(pRequest.Target);
+				  }
+				  return HttpReply{200, pRequest.Target};
+			  }) {}
+
+		~BlockingServer() {
+			Release();
+		}
+
+		SimpleNetworkStack::RequestHandle Block(SimpleNetworkStack& pNetworkStack) {
+			auto handle = pNetworkStack.QueueGet(mServer.Url("/block"));
+			mBlocked.get_future().wait();
+			return handle;
+		}
+
+		SimpleNetworkStack::RequestHandle Block(SimpleNetworkStack& pNetworkStack, SimpleNetworkStack::ResultPromise pPromise) {
+			auto handle = pNetworkStack.QueueGet(mServer.Url("/block"), std::move(pPromise));
+			mBlocked.get_future().wait();
+			return handle;
+		}
+
+		void Release() {
+			if (!mReleased.exchange(true)) {
+				mReleasePromise.set_value();
+			}
+		}
+
+		std::vector<std::string> Order() {
+			std::lock_guard guard(mMutex);
+			return mOrder;
+		}
+
+		LocalHttpServer& Server() { return mServer; }
+
+	private:
+		std::promise<void> mBlocked;
+		std::promise<void> mReleasePromise;
+		std::shared_future<void> mRelease = mReleasePromise.get_future().share();
+		std::atomic_bool mReleased = false;
+		std::mutex mMutex;
+		std::vector<std::string> mOrder;
+		LocalHttpServer mServer;
+	};
+} // namespace
+
+TEST_F(SimpleNetworkStackTests, Priority) {
+	BlockingServer server;
+	SimpleNetworkStack networkStack;
+	networkStack.SetMaxConcurrentTransfers(1);
+	server.Block(networkStack);
+
+	std::promise<SimpleNetworkStack::Result> last;
+	auto lastFuture = last.get_future();
+	networkStack.QueueGet(server.Server().Url("/low"), std::move(last), "", SimpleNetworkStack::Priority::Low);
+	networkStack.QueueGet(server.Server().Url("/normal1"));
+	networkStack.QueueGet(server.Server().Url("/high"), "", SimpleNetworkStack::Priority::High);
+	networkStack.QueueGet(server.Server().Url("/normal2"));
+	EXPECT_EQ(networkStack.QueueSize(), 4);
+
+	server.Release();
+	ASSERT_TRUE(lastFuture.get().has_value());
+	EXPECT_EQ(server.Order(), (std::vector<std::string>{"/high", "/normal1", "/normal2", "/low"}));
+}
+
+TEST_F(SimpleNetworkStackTests, CancelQueued) {
+	BlockingServer server;
+	SimpleNetworkStack networkStack;
+	networkStack.SetMaxConcurrentTransfers(1);
+	server.Block(networkStack);
+
+	std::promise<SimpleNetworkStack::Result> promise;
+	auto future = promise.get_future();
+	auto first = networkStack.QueueGet(server.Server().Url("/first"), std::move(promise));
+	bool called = false;
+	auto second = networkStack.QueueGet(server.Server().Url("/second"), [&called](const SimpleNetworkStack::Result&) {
+		called = true;
+	});
+	auto third = networkStack.QueueGet(server.Server().Url("/third"));
+
+	EXPECT_EQ(networkStack.QueuePosition(first), 0);
+	EXPECT_EQ(networkStack.QueuePosition(second), 1);
+	EXPECT_EQ(networkStack.QueuePosition(third), 2);
+
+	first.Cancel();
+	second.Cancel();
+	EXPECT_TRUE(first.Cancelled());
+	EXPECT_EQ(networkStack.QueuePosition(first), std::nullopt);
+	EXPECT_EQ(networkStack.QueuePosition(third), 0);
+
+	std::promise<SimpleNetworkStack::Result> done;
+	auto doneFuture = done.get_future();
+	networkStack.QueueGet(server.Server().Url("/done"), std::move(done));
+	server.Release();
+
+	auto response = future.get();
+	ASSERT_FALSE(response.has_value());
+	EXPECT_EQ(response.error().Type, SimpleNetworkStack::ErrorType::Cancelled);
+	ASSERT_TRUE(doneFuture.get().has_value());
+	EXPECT_FALSE(called);
+	EXPECT_EQ(server.Order(), (std::vector<std::string>{"/third", "/done"}));
+}
+
+TEST_F(SimpleNetworkStackTests, CancelCoalesced) {
+	BlockingServer server;
+	SimpleNetworkStack networkStack;
+	networkStack.SetMaxConcurrentTransfers(1);
+	server.Block(networkStack);
+
+	std::promise<SimpleNetworkStack::Result> cancelled;
+	auto cancelledFuture = cancelled.get_future();
+	auto handle = networkStack.QueueGet(server.Server().Url("/shared"), std::move(cancelled));
+	std::promise<SimpleNetworkStack::Result> kept;
+	auto keptFuture = kept.get_future();
+	networkStack.QueueGet(server.Server().Url("/shared"), std::move(kept));
+	handle.Cancel();
+	server.Release();
+
+	auto keptResponse = keptFuture.get();
+	ASSERT_TRUE(keptResponse.has_value());
+	EXPECT_EQ(keptResponse->Message, "/shared");
+	auto cancelledResponse = cancelledFuture.get();
+	ASSERT_FALSE(cancelledResponse.has_value());
+	EXPECT_EQ(cancelledResponse.error().Type, SimpleNetworkStack::ErrorType::Cancelled);
+}
+
+TEST_F(SimpleNetworkStackTests, CancelRunning) {
+	BlockingServer server;
+	SimpleNetworkStack networkStack;
+
+	std::promise<SimpleNetworkStack::Result> promise;
+	auto future = promise.get_future();
+	// the server received the request and doesn't answer
+	auto handle = server.Block(networkStack, std::move(promise));
+	handle.Cancel();
+
+	ASSERT_EQ(future.wait_for(std::chrono::seconds(3)), std::future_status::ready);
+	auto response = future.get();
+	ASSERT_FALSE(response.has_value());
+	EXPECT_EQ(response.error().Type, SimpleNetworkStack::ErrorType::Cancelled);
+}
+
+TEST_F(SimpleNetworkStackTests, Stream) {
+	const std::string body(1 << 20, 'x');
+	LocalHttpServer server([&body](const HttpRequest&) {
+		return HttpReply{200, body};
+	});
+	SimpleNetworkStack networkStack;
+
+	size_t received = 0;
+	size_t chunks = 0;
+	std::promise<SimpleNetworkStack::Result> promise;
+	auto future = promise.get_future();
+	networkStack.QueueStream(
+			server.Url("/big"),
+			[&](std::string_view pChunk) {
+				received += pChunk.size();
+				++chunks;
+				return true;
+			},
+			std::move(promise)
+	);
+
+	auto response = future.get();
+	ASSERT_TRUE(response.has_value());
+	EXPECT_EQ(response->Code, 200);
+	EXPECT_TRUE(response->Message.empty());
+	EXPECT_EQ(received, body.size());
+	EXPECT_GT(chunks, 1);
+}
+
+TEST_F(SimpleNetworkStackTests, StreamAbort) {
+	LocalHttpServer server([](const HttpRequest&) {
+		return HttpReply{200, std::string(1 << 20, 'x')};
+	});
+	SimpleNetworkStack networkStack;
+
+	std::promise<SimpleNetworkStack::Result> promise;
+	auto future = promise.get_future();
+	networkStack.QueueStream(
+			server.Url("/big"),
+			[](std::string_view) {
+				return false;
+			},
+			std::move(promise)
+	);
+
+	auto response = future.get();
+	ASSERT_FALSE(response.has_value());
+	EXPECT_EQ(response.error().Type, SimpleNetworkStack::ErrorType::PerformError);
+}
+
+TEST_F(SimpleNetworkStackTests, StreamThrows) {
+	LocalHttpServer server([](const HttpRequest&) {
+		return HttpReply{200, std::string(1 << 20, 'x')};
+	});
+	SimpleNetworkStack networkStack;
+
+	std::promise<SimpleNetworkStack::Result> promise;
+	auto future = promise.get_future();
+	networkStack.QueueStream(
+			server.Url("/big"),
+			[](std::string_view) -> bool {
+				throw std::runtime_error("parser failed");
+			},
+			std::move(promise)
+	);
+
+	// the exception doesn't leave the network thread through libcurl
+	auto response = future.get();
+	ASSERT_FALSE(response.has_value());
+	EXPECT_EQ(response.error().Type, SimpleNetworkStack::ErrorType::PerformError);
+}
+
+TEST_F(SimpleNetworkStackTests, RetryTransientFailure) {
+	std::atomic_int requests = 0;
+	LocalHttpServer server([&requests](const HttpRequest&) {
+		// the first two attempts fail
+		if (++requests <= 2) {
+			return HttpReply{503, "unavailable"};
+		}
+		return HttpReply{200, "ok"};
+	});
+	SimpleNetworkStack networkStack;
+	networkStack.SetRetryPolicy({.MaxAttempts = 3, .BaseDelay = std::chrono::milliseconds(10), .MaxDelay = std::chrono::milliseconds(50)});
+
+	std::promise<SimpleNetworkStack::Result> promise;
+	auto future = promise.get_future();
+	networkStack.QueueGet(server.Url("/flaky"), std::move(promise));
+	auto response = future.get();
+	ASSERT_TRUE(response.has_value());
+	EXPECT_EQ(response->Code, 200);
+	EXPECT_EQ(response->Message, "ok");
+	EXPECT_EQ(requests.load(), 3);
+
+	// out of attempts, the last response is passed on
+	requests = -10;
+	std::promise<SimpleNetworkStack::Result> failing;
+	auto failingFuture = failing.get_future();
+	networkStack.QueueGet(server.Url("/down"), std::move(failing));
+	response = failingFuture.get();
+	ASSERT_TRUE(response.has_value());
+	EXPECT_EQ(response->Code, 503);
+	EXPECT_EQ(requests.load(), -7);
+}
+
+TEST_F(SimpleNetworkStackTests, RetryForCoalesced) {
+	std::promise<void> arrived;
+	std::promise<void> release;
+	std::shared_future<void> released = release.get_future().share();
+	std::atomic_int requests = 0;
+	LocalHttpServer server([&](const HttpRequest&) {
+		if (requests++ == 0) {
+			arrived.set_value();
+			released.wait();
+			return HttpReply{500, "error"};
+		}
+		return HttpReply{200, "ok"};
+	});
+	SimpleNetworkStack networkStack;
+	networkStack.SetRetryPolicy({.MaxAttempts = 2, .BaseDelay = std::chrono::milliseconds(10)});
+
+	std::promise<SimpleNetworkStack::Result> cancelled;
+	auto cancelledFuture = cancelled.get_future();
+	auto handle = networkStack.QueueGet(server.Url("/flaky"), std::move(cancelled));
+	arrived.get_future().wait();
+	std::promise<SimpleNetworkStack::Result> kept;
+	auto keptFuture = kept.get_future();
+	networkStack.QueueGet(server.Url("/flaky"), std::move(kept));
+
+	// the first request is cancelled, the retry still happens for the coalesced one
+	handle.Cancel();
+	release.set_value();
+
+	auto keptResponse = keptFuture.get();
+	ASSERT_TRUE(keptResponse.has_value());
+	EXPECT_EQ(keptResponse->Code, 200);
+	auto cancelledResponse = cancelledFuture.get();
+	ASSERT_FALSE(cancelledResponse.has_value());
+	EXPECT_EQ(cancelledResponse.error().Type, SimpleNetworkStack::ErrorType::Cancelled);
+	EXPECT_EQ(requests.load(), 2);
+}
+
+TEST_F(SimpleNetworkStackTests, NoRetryOnClientError) {
+	LocalHttpServer server([](const HttpRequest&) {
+		return HttpReply{404, "missing"};
+	});
+	SimpleNetworkStack networkStack;
+	networkStack.SetRetryPolicy({.MaxAttempts = 3, .BaseDelay = std::chrono::milliseconds(10)});
+
+	std::promise<SimpleNetworkStack::Result> promise;
+	auto future = promise.get_future();
+	networkStack.QueueGet(server.Url("/missing"), std::move(promise));
+	auto response = future.get();
+	ASSERT_TRUE(response.has_value());
+	EXPECT_EQ(response->Code, 404);
+	EXPECT_EQ(server.RequestCount(), 1);
+}
+
+TEST_F(SimpleNetworkStackTests, CircuitBreaker) {
+	std::atomic_bool down = true;
+	LocalHttpServer server([&down](const HttpRequest&) {
+		return down ? HttpReply{500, "down"} : HttpReply{200, "up"};
+	});
+	SimpleNetworkStack networkStack;
+	networkStack.SetRetryPolicy({.MaxAttempts = 1});
+	networkStack.SetCircuitBreakerPolicy({.FailureThreshold = 2, .OpenDuration = std::chrono::milliseconds(200)});
+
+	auto get = [&] {
+		std::promise<SimpleNetworkStack::Result> promise;
+		auto future = promise.get_future();
+		networkStack.QueueGet(server.Url("/"), std::move(promise));
+		return future.get();
+	};
+
+	const std::string host = SimpleNetworkStack::GetHost(server.Url("/"));
+	EXPECT_EQ(host, "127.0.0.1");
+	EXPECT_EQ(get()->Code, 500);
+	EXPECT_EQ(networkStack.GetCircuitState(host), SimpleNetworkStack::CircuitState::Closed);
+	EXPECT_EQ(get()->Code, 500);
+	EXPECT_EQ(networkStack.GetCircuitState(host), SimpleNetworkStack::CircuitState::Open);
+
+	// fails without asking the server
+	auto response = get();
+	ASSERT_FALSE(response.has_value());
+	EXPECT_EQ(response.error().Type, SimpleNetworkStack::ErrorType::CircuitOpen);
+	EXPECT_EQ(server.RequestCount(), 2);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(250));
+	EXPECT_EQ(networkStack.GetCircuitState(host), SimpleNetworkStack::CircuitState::HalfOpen);
+	down = false;
+	response = get();
+	ASSERT_TRUE(response.has_value());
+	EXPECT_EQ(response->Code, 200);
+	EXPECT_EQ(networkStack.GetCircuitState(host), SimpleNetworkStack::CircuitState::Closed);
+}
+
+TEST_F(SimpleNetworkStackTests, CacheWithOpenCircuit) {
+	const auto cacheDir = std::filesystem::temp_directory_path() / "SimpleNetworkStackTestsCircuitCache";
+	std::filesystem::remove_all(cacheDir);
+
+	std::atomic_bool down = false;
+	LocalHttpServer server([&down](const HttpRequest& pRequest) {
+		if (down) {
+			return HttpReply{500, "down"};
+		}
+		return HttpReply{200, pRequest.Target, {{"Cache-Control", "max-age=3600"}}};
+	});
+	SimpleNetworkStack networkStack;
+	networkStack.SetCacheDirectory(cacheDir);
+	networkStack.SetRetryPolicy({.MaxAttempts = 1});
+	networkStack.SetCircuitBreakerPolicy({.FailureThreshold = 1, .OpenDuration = std::chrono::milliseconds(100)});
+	const std::string host = SimpleNetworkStack::GetHost(server.Url("/"));
+
+	auto get = [&](const std::string& pTarget) {
+		std::promise<SimpleNetworkStack::Result> promise;
+		auto future = promise.get_future();
+		networkStack.QueueGet(server.Url(pTarget), std::move(promise));
+		return future.get();
+	};
+
+	EXPECT_EQ(get("/fresh")->Code, 200);
+	down = true;
+	EXPECT_EQ(get("/other")->Code, 500);
+	EXPECT_EQ(networkStack.GetCircuitState(host), SimpleNetworkStack::CircuitState::Open);
+
+	// fresh entries are served while the host is down
+	auto cached = get("/fresh");
+	ASSERT_TRUE(cached.has_value());
+	EXPECT_TRUE(cached->Cached);
+
+	// and don't use up the trial request of the half open circuit
+	std::this_thread::sleep_for(std::chrono::milliseconds(150));
+	EXPECT_EQ(networkStack.GetCircuitState(host), SimpleNetworkStack::CircuitState::HalfOpen);
+	cached = get("/fresh");
+	ASSERT_TRUE(cached.has_value());
+	EXPECT_TRUE(cached->Cached);
+
+	down = false;
+	auto trial = get("/other");
+	ASSERT_TRUE(trial.has_value());
+	EXPECT_EQ(trial->Code, 200);
+	EXPECT_EQ(networkStack.GetCircuitState(host), SimpleNetworkStack::CircuitState::Closed);
+	EXPECT_EQ(server.RequestCount(), 3);
+
+	std::filesystem::remove_all(cacheDir);
+}
+
+TEST_F(SimpleNetworkStackTests, RateLimit) {
+	std::mutex mutex;
+	std::vector<std::chrono::steady_clock::time_point> arrivals;
+	LocalHttpServer server([&](const HttpRequest&) {
+		std::lock_guard lock(mutex);
+		arrivals.emplace_back(std::chrono::steady_clock::now());
+		return HttpReply{200, "ok"};
+	});
+	SimpleNetworkStack networkStack;
+	const std::string host = SimpleNetworkStack::GetHost(server.Url("/"));
+	EXPECT_FALSE(networkStack.GetBucketState(host).has_value());
+	networkStack.SetRateLimit(host, {.RequestsPerSecond = 20, .Burst = 2});
+
+	// two go right away, the other four one every 50ms
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<std::future<SimpleNetworkStack::Result>> futures;
+	for (int i = 0; i < 6; ++i) {
+		std::promise<SimpleNetworkStack::Result> promise;
+		futures.emplace_back(promise.get_future());
+		networkStack.QueueGet(server.Url(std::format("/{}", i)), std::move(promise));
+	}
+	for (auto& future : futures) {
+		auto result = future.get();
+		ASSERT_TRUE(result.has_value());
+		EXPECT_EQ(result->Code, 200);
+	}
+
+	std::lock_guard lock(mutex);
+	ASSERT_EQ(arrivals.size(), 6);
+	std::ranges::sort(arrivals);
+	EXPECT_LT(arrivals[1] - start, std::chrono::milliseconds(40));
+	EXPECT_GE(arrivals[5] - start, std::chrono::milliseconds(190));
+
+	const auto state = networkStack.GetBucketState(host);
+	ASSERT_TRUE(state.has_value());
+	EXPECT_EQ(state->Limit.Burst, 2);
+	EXPECT_LT(state->Tokens, 1);
+	EXPECT_EQ(state->BlockedFor.count(), 0);
+
+	networkStack.RemoveRateLimit(host);
+	EXPECT_FALSE(networkStack.GetBucketState(host).has_value());
+}
+
+TEST_F(SimpleNetworkStackTests, RetryAfter) {
+	std::atomic_int requests = 0;
+	LocalHttpServer server([&requests](const HttpRequest&) {
+		if (requests++ == 0) {
+			return HttpReply{429, "slow down", {{"Retry-After", "1"}}};
+		}
+		return HttpReply{200, "ok"};
+	});
+	SimpleNetworkStack networkStack;
+	networkStack.SetRetryPolicy({.MaxAttempts = 2, .BaseDelay = std::chrono::milliseconds(10)});
+	networkStack.SetCircuitBreakerPolicy({.FailureThreshold = 1});
+	const std::string host = SimpleNetworkStack::GetHost(server.Url("/"));
+
+	const auto start = std::chrono::steady_clock::now();
+	std::promise<SimpleNetworkStack::Result> promise;
+	auto future = promise.get_future();
+	networkStack.QueueGet(server.Url("/"), std::move(promise));
+
+	// the host is paused after the first answer
+	while (server.RequestCount() == 0) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	const auto state = networkStack.GetBucketState(host);
+	ASSERT_TRUE(state.has_value());
+	EXPECT_GT(state->BlockedFor.count(), 0);
+
+	auto result = future.get();
+	ASSERT_TRUE(result.has_value());
+	EXPECT_EQ(result->Code, 200);
+	EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(950));
+	EXPECT_EQ(server.RequestCount(), 2);
+	// 429 is no sign of a broken host
+	EXPECT_EQ(networkStack.GetCircuitState(host), SimpleNetworkStack::CircuitState::Closed);
+	// the pause is over, the host has no bucket anymore
+	EXPECT_FALSE(networkStack.GetBucketState(host).has_value());
+}
+
+TEST_F(SimpleNetworkStackTests, Timing) {
+	const std::string body(64 * 1024, 'x');
+	LocalHttpServer server([&body](const HttpRequest&) {
+		return HttpReply{.Body = body, .Delay = std::chrono::milliseconds(30)};
+	});
+	SimpleNetworkStack networkStack;
+	const std::string host = SimpleNetworkStack::GetHost(server.Url("/"));
+	EXPECT_FALSE(networkStack.GetTimings(host).has_value());
+
+	for (int i = 0; i < 3; ++i) {
+		std::promise<SimpleNetworkStack::Result> promise;
+		auto future = promise.get_future();
+		networkStack.QueueGet(server.Url(std::format("/{}", i)), std::move(promise));
+		auto result = future.get();
+		ASSERT_TRUE(result.has_value());
+		ASSERT_TRUE(result->Timing.has_value());
+
+		const auto& timing = *result->Timing;
+		EXPECT_GE(timing.StartTransfer, 25);
+		EXPECT_GE(timing.Total, timing.StartTransfer);
+		EXPECT_EQ(timing.Size, body.size());
+		EXPECT_GT(timing.Speed, 0);
+	}
+
+	const auto timings = networkStack.GetTimings(host);
+	ASSERT_TRUE(timings.has_value());
+	EXPECT_EQ(timings->Total.Count(), 3);
+	EXPECT_EQ(timings->Bytes, 3 * body.size());
+	EXPECT_GE(timings->StartTransfer.Quantile(0.5), 25);
+	EXPECT_EQ(networkStack.GetAllTimings().size(), 1);
+
+	networkStack.ResetTimings();
+	EXPECT_FALSE(networkStack.GetTimings(host).has_value());
+}
+
+TEST_F(SimpleNetworkStackTests, ReuseConnection) {
+	LocalHttpServer server([](const HttpRequest&) {
+		return HttpReply{200, "ok"};
+	});
+	SimpleNetworkStack networkStack;
+	networkStack.SetMaxConcurrentTransfers(1);
+
+	// one after the other, the connection of the first request is kept for the next ones.
+	// This is done by the multi handle, it passes without the share as well,
+	// sharing TLS sessions would need a local TLS server and isn't tested here.
+	for (int i = 0; i < 4; ++i) {
+		std::promise<SimpleNetworkStack::Result> promise;
+		auto future = promise.get_future();
+		networkStack.QueueGet(server.Url(std::format("/{}", i)), std::move(promise));
+		auto result = future.get();
+		ASSERT_TRUE(result.has_value());
+		ASSERT_TRUE(result->Timing.has_value());
+		if (i > 0) {
+			// no new connection, so no connect phase
+			EXPECT_EQ(result->Timing->Connect, 0);
+		}
+	}
+	EXPECT_EQ(server.ConnectionCount(), 1);
+}
+
+TEST_F(SimpleNetworkStackTests, Coroutine) {
+	LocalHttpServer server([](const HttpRequest& pRequest) {
+		return HttpReply{200, pRequest.Target == "/first" ? "/second" : "done"};
+	});
+	SimpleNetworkStack networkStack;
+	QueueExecutor executor;
+	std::jthread thread([&executor](const std::stop_token& pToken) {
+		executor.Run(pToken);
+	});
+
+	std::promise<std::pair<std::string, bool>> promise;
+	auto future = promise.get_future();
+	// the second request depends on the first one, without a thread waiting in between
+	[](SimpleNetworkStack& pNetworkStack, const LocalHttpServer& pServer, QueueExecutor& pExecutor, std::thread::id pThreadId, std::promise<std::pair<std::string, bool>>& pPromise) -> Task<> {
+		auto first = co_await pNetworkStack.Get(pServer.Url("/first"), &pExecutor);
+		const bool onExecutor = std::this_thread::get_id() == pThreadId;
+		if (!first) {
+			pPromise.set_value({first.error().Message, onExecutor});
+			co_return;
+		}
+		auto second = co_await pNetworkStack.Get(pServer.Url(first->Message), &pExecutor);
+		pPromise.set_value({second ? second->Message : second.error().Message, onExecutor && std::this_thread::get_id() == pThreadId});
+	}(networkStack, server, executor, thread.get_id(), promise).Start();
+
+	auto [message, onExecutor] = future.get();
+	EXPECT_EQ(message, "done");
+	EXPECT_TRUE(onExecutor);
+	EXPECT_EQ(server.RequestCount(), 2);
+}
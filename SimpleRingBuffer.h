@@ -1,13 +1,108 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
+#include <compare>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <memory>
 #include <ostream>
+#include <span>
+#include <type_traits>
+#include <utility>
 
 namespace ArcdpsExtension {
 	/**
+	 * Random access iterator over every container, that has an O(1) `operator[]`.
+	 * It only holds the parent and a logical index (0 is the oldest element), so it is trivially copyable
+	 * and all arithmetic is plain integer arithmetic. Used by `MaskedRingBuffer`.
+	 *
+	 * @tparam Container The parent container, `const` for const iterators.
+	 * @tparam T The element type, `const` for const iterators.
+	 */
+	template<typename Container, typename T>
+	class RingBufferIndexIterator {
+	public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = std::remove_cv_t<T>;
+		using pointer = T*;
+		using reference = T&;
+		using iterator_category = std::random_access_iterator_tag;
+		using iterator_concept = std::random_access_iterator_tag;
+
+		constexpr RingBufferIndexIterator() = default;
+		constexpr RingBufferIndexIterator(Container* pParent, size_t pIndex) : mParent(pParent), mIndex(pIndex) {}
+
+		constexpr bool operator==(const RingBufferIndexIterator& pOther) const {
+			return mIndex == pOther.mIndex;
+		}
+		constexpr std::strong_ordering operator<=>(const RingBufferIndexIterator& pOther) const {
+			return mIndex <=> pOther.mIndex;
+		}
+
+		constexpr reference operator*() const { return (*mParent)[mIndex]; }
+		constexpr pointer operator->() const { return &(*mParent)[mIndex]; }
+		constexpr reference operator[](const difference_type pNum) const { return (*mParent)[mIndex + pNum]; }
+
+		constexpr RingBufferIndexIterator& operator++() {
+			++mIndex;
+			return *this;
+		}
+		constexpr RingBufferIndexIterator& operator--() {
+			--mIndex;
+			return *this;
+		}
+		constexpr RingBufferIndexIterator operator++(int) {
+			RingBufferIndexIterator tmp = *this;
+			++mIndex;
+			return tmp;
+		}
+		constexpr RingBufferIndexIterator operator--(int) {
+			RingBufferIndexIterator tmp = *this;
+			--mIndex;
+			return tmp;
+		}
+
+		constexpr difference_type operator-(const RingBufferIndexIterator& pOther) const {
+			return static_cast<difference_type>(mIndex) - static_cast<difference_type>(pOther.mIndex);
+		}
+
+		constexpr RingBufferIndexIterator& operator+=(const difference_type pNum) {
+			mIndex += pNum;
+			return *this;
+		}
+		constexpr RingBufferIndexIterator& operator-=(const difference_type pNum) {
+			mIndex -= pNum;
+			return *this;
+		}
+		constexpr RingBufferIndexIterator operator+(const difference_type pNum) const {
+			return RingBufferIndexIterator(mParent, mIndex + pNum);
+		}
+		constexpr RingBufferIndexIterator operator-(const difference_type pNum) const {
+			return RingBufferIndexIterator(mParent, mIndex - pNum);
+		}
+		friend constexpr RingBufferIndexIterator operator+(const difference_type pLhs, const RingBufferIndexIterator& pRhs) {
+			return pRhs + pLhs;
+		}
+
+		/**
+		 * Logical position in the parent, 0 is the oldest element.
+		 */
+		[[nodiscard]] constexpr size_t Index() const {
+			return mIndex;
+		}
+
+	private:
+		Container* mParent = nullptr;
+		size_t mIndex = 0;
+	};
+
+	/**
  * @tparam T The type that this buffer holds.
  */
 	template<typename T, typename Allocator = std::allocator<T>>
@@ -28,7 +123,7 @@ namespace ArcdpsExtension {
 			}
 		}
 
-		RingBuffer(const RingBuffer& pOther) {
+		RingBuffer(const RingBuffer& pOther) : mNotifyEvict(pOther.mNotifyEvict) {
 			size_t size = pOther.Size();
 			mCapacityBegin = mAlloc.allocate(size);
 			mCapacityEnd = mCapacityBegin + size;
@@ -45,7 +140,8 @@ namespace ArcdpsExtension {
 			  mSizeEnd(pOther.mSizeEnd),
 			  mCapacityBegin(pOther.mCapacityBegin),
 			  mCapacityEnd(pOther.mCapacityEnd),
-			  mAlloc(std::move(pOther.mAlloc)) {
+			  mAlloc(std::move(pOther.mAlloc)),
+			  mNotifyEvict(pOther.mNotifyEvict) {
 			pOther.mCapacityBegin = nullptr;
 		}
 
@@ -79,6 +175,12 @@ namespace ArcdpsExtension {
 		void PushBack(T&& pElement);
 		void PushBack(const T& pElement);
 
+		/**
+		 * Push all elements in order. Uses `memcpy` for trivially copyable types.
+		 * If there are more elements than capacity, only the last ones are kept.
+		 */
+		void PushBack(std::span<const T> pElements);
+
 		template<typename... Args>
 		void EmplaceBack(const Args&... args);
 
@@ -89,6 +191,13 @@ namespace ArcdpsExtension {
 		size_t Size() const;
 		void Resize(size_t pNewCapacity);
 
+		/**
+		 * The content as at most two contiguous parts, oldest first. The second span is empty, if the buffer did not wrap.
+		 * Use this for `memcpy` or vectorized loops over the whole buffer.
+		 */
+		std::array<std::span<T>, 2> Segments();
+		std::array<std::span<const T>, 2> Segments() const;
+
 		const T& operator[](size_t pNum) const;
 		T& operator[](size_t pNum);
 
@@ -247,7 +356,7 @@ namespace ArcdpsExtension {
 			pointer mPtr = nullptr;
 			bool mBegin = false;
 			bool mEnd = false;
-			const RingBuffer<T>* mParent = nullptr;
+			const RingBuffer<T, Allocator>* mParent = nullptr;
 		};
 
 
@@ -267,22 +376,268 @@ namespace ArcdpsExtension {
 		const RingBufferIterator crbegin() const { return std::make_reverse_iterator(end()); }
 		const RingBufferIterator crend() const { return std::make_reverse_iterator(begin()); }
 
+	protected:
+		/**
+		 * Called with the oldest element, right before it is overwritten by a push (also when `Resize()` drops elements).
+		 * Not called by `Clear()`. Override it to aggregate or persist the data, that is about to be lost.
+		 * Only called after `EnableOnEvict()`, so buffers without override keep the plain push and the `memcpy` bulk push.
+		 */
+		virtual void OnEvict(T&) {}
+
+		/**
+		 * Call this in the constructor of classes, that override `OnEvict`.
+		 */
+		void EnableOnEvict() {
+			mNotifyEvict = true;
+		}
+
 	private:
 		T* mCurrent;
 		T* mSizeEnd;
 		T* mCapacityBegin;
 		T* mCapacityEnd;
 		Allocator mAlloc;
+		bool mNotifyEvict = false;
 
 		T* pushOne();
 		[[nodiscard]] T* advance(T* pElem) const;
 		[[nodiscard]] T* retreat(T* pElem) const;
+		[[nodiscard]] size_t index(size_t pNum) const;
+	};
+
+	/**
+	 * `RingBuffer` with a power of two capacity. Elements are addressed with a monotonically increasing index, wraparound is a single mask.
+	 * `operator[]` is branchless and the iterator is a trivially copyable (parent, index) pair,
+	 * so `std::ranges` algorithms (e.g. `sort`, `lower_bound`) and simple loops over it run at array speed.
+	 * <br>
+	 * Same interface as `RingBuffer`, the oldest element is overwritten when it is full.
+	 * The capacity is rounded up to the next power of two.
+	 *
+	 * @tparam T The type that this buffer holds.
+	 */
+	template<typename T, typename Allocator = std::allocator<T>>
+	class MaskedRingBuffer {
+	public:
+		using iterator = RingBufferIndexIterator<MaskedRingBuffer, T>;
+		using const_iterator = RingBufferIndexIterator<const MaskedRingBuffer, const T>;
+
+		explicit MaskedRingBuffer(size_t pInitialCapacity, const Allocator& pAlloc = Allocator()) : mAlloc(pAlloc) {
+			allocate(pInitialCapacity);
+		}
+
+		virtual ~MaskedRingBuffer() {
+			if (mData) {
+				Clear();
+				mAlloc.deallocate(mData, mMask + 1);
+			}
+		}
+
+		MaskedRingBuffer(const MaskedRingBuffer& pOther) : mAlloc(pOther.mAlloc) {
+			allocate(pOther.Capacity());
+			for (const auto& other : pOther) {
+				PushBack(other);
+			}
+		}
+
+		MaskedRingBuffer(MaskedRingBuffer&& pOther) noexcept
+			: mData(std::exchange(pOther.mData, nullptr)),
+			  mMask(pOther.mMask),
+			  mHead(pOther.mHead),
+			  mSize(pOther.mSize),
+			  mAlloc(std::move(pOther.mAlloc)) {}
+
+		MaskedRingBuffer& operator=(const MaskedRingBuffer& pOther) {
+			if (this == &pOther)
+				return *this;
+			MaskedRingBuffer copy(pOther);
+			swap(copy);
+			return *this;
+		}
+
+		MaskedRingBuffer& operator=(MaskedRingBuffer&& pOther) noexcept {
+			if (this == &pOther)
+				return *this;
+			MaskedRingBuffer moved(std::move(pOther));
+			swap(moved);
+			return *this;
+		}
+
+		void PushBack(T&& pElement);
+		void PushBack(const T& pElement);
+
+		/**
+		 * Same as `RingBuffer::PushBack(std::span<const T>)`.
+		 */
+		void PushBack(std::span<const T> pElements);
+
+		template<typename... Args>
+		void EmplaceBack(Args&&... args);
+
+		T& Back();
+		const T& Back() const;
+
+		void Clear();
+		[[nodiscard]] size_t Size() const;
+		[[nodiscard]] size_t Capacity() const;
+		void Resize(size_t pNewCapacity);
+
+		/**
+		 * Same as `RingBuffer::Segments()`.
+		 */
+		std::array<std::span<T>, 2> Segments();
+		std::array<std::span<const T>, 2> Segments() const;
+
+		const T& operator[](size_t pNum) const;
+		T& operator[](size_t pNum);
+
+		iterator begin() { return iterator(this, 0); }
+		iterator end() { return iterator(this, mSize); }
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, mSize); }
+		const_iterator cbegin() const { return begin(); }
+		const_iterator cend() const { return end(); }
+		auto rbegin() { return std::make_reverse_iterator(end()); }
+		auto rend() { return std::make_reverse_iterator(begin()); }
+		auto rbegin() const { return std::make_reverse_iterator(end()); }
+		auto rend() const { return std::make_reverse_iterator(begin()); }
+
+	private:
+		T* mData = nullptr;
+		size_t mMask = 0;
+		uint64_t mHead = 0; // number of pushed elements since the last `Clear()`
+		size_t mSize = 0;
+		Allocator mAlloc;
+
+		void allocate(size_t pCapacity);
+		T* pushOne();
+		void swap(MaskedRingBuffer& pOther) noexcept;
+	};
+
+	static_assert(std::is_trivially_copyable_v<MaskedRingBuffer<uint64_t>::iterator>);
+
+	/**
+	 * `RingBuffer` with a capacity known at compile time. The elements are stored inline, there is no heap allocation.
+	 * Wraparound is a mask, if `N` is a power of two. All operations are constexpr.
+	 * <br>
+	 * Same interface as `MaskedRingBuffer` (without `Resize()`), the oldest element is overwritten when it is full.
+	 * Elements are assigned into a `std::array`, so `T` has to be default constructible.
+	 * Removed elements stay alive until they are overwritten, `Clear()` only assigns `T{}` to them if `T` is not trivial.
+	 *
+	 * @tparam T The type that this buffer holds.
+	 * @tparam N The capacity.
+	 */
+	template<typename T, size_t N>
+	class StaticRingBuffer {
+		static_assert(N > 0, "StaticRingBuffer needs a capacity");
+
+	public:
+		using iterator = RingBufferIndexIterator<StaticRingBuffer, T>;
+		using const_iterator = RingBufferIndexIterator<const StaticRingBuffer, const T>;
+
+		constexpr StaticRingBuffer() = default;
+
+		constexpr void PushBack(T&& pElement) {
+			pushOne() = std::move(pElement);
+		}
+
+		constexpr void PushBack(const T& pElement) {
+			pushOne() = pElement;
+		}
+
+		/**
+		 * Same as `RingBuffer::PushBack(std::span<const T>)`.
+		 */
+		constexpr void PushBack(std::span<const T> pElements) {
+			if (pElements.size() > N) {
+				pElements = pElements.last(N);
+			}
+			const size_t pos = wrap(mHead);
+			const size_t first = std::min(pElements.size(), N - pos);
+			std::copy_n(pElements.begin(), first, mData.begin() + pos);
+			std::copy(pElements.begin() + first, pElements.end(), mData.begin());
+			mHead += pElements.size();
+			mSize = std::min(mSize + pElements.size(), N);
+		}
+
+		template<typename... Args>
+		constexpr void EmplaceBack(Args&&... args) {
+			pushOne() = T(std::forward<Args>(args)...);
+		}
+
+		constexpr T& Back() { return mData[wrap(mHead - 1)]; }
+		constexpr const T& Back() const { return mData[wrap(mHead - 1)]; }
+
+		constexpr void Clear() {
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				for (T& elem : *this) {
+					elem = T{};
+				}
+			}
+			mHead = 0;
+			mSize = 0;
+		}
+
+		[[nodiscard]] constexpr size_t Size() const { return mSize; }
+		[[nodiscard]] static constexpr size_t Capacity() { return N; }
+
+		/**
+		 * Same as `RingBuffer::Segments()`.
+		 */
+		constexpr std::array<std::span<T>, 2> Segments() {
+			const size_t start = wrap(mHead - mSize);
+			const size_t first = std::min(mSize, N - start);
+			return {std::span<T>(mData.data() + start, first), std::span<T>(mData.data(), mSize - first)};
+		}
+
+		constexpr std::array<std::span<const T>, 2> Segments() const {
+			const size_t start = wrap(mHead - mSize);
+			const size_t first = std::min(mSize, N - start);
+			return {std::span<const T>(mData.data() + start, first), std::span<const T>(mData.data(), mSize - first)};
+		}
+
+		constexpr const T& operator[](size_t pNum) const { return mData[wrap(mHead - mSize + pNum)]; }
+		constexpr T& operator[](size_t pNum) { return mData[wrap(mHead - mSize + pNum)]; }
+
+		constexpr iterator begin() { return iterator(this, 0); }
+		constexpr iterator end() { return iterator(this, mSize); }
+		constexpr const_iterator begin() const { return const_iterator(this, 0); }
+		constexpr const_iterator end() const { return const_iterator(this, mSize); }
+		constexpr const_iterator cbegin() const { return begin(); }
+		constexpr const_iterator cend() const { return end(); }
+		constexpr auto rbegin() { return std::make_reverse_iterator(end()); }
+		constexpr auto rend() { return std::make_reverse_iterator(begin()); }
+		constexpr auto rbegin() const { return std::make_reverse_iterator(end()); }
+		constexpr auto rend() const { return std::make_reverse_iterator(begin()); }
+
+	private:
+		std::array<T, N> mData{};
+		size_t mHead = 0; // number of pushed elements since the last `Clear()`
+		size_t mSize = 0;
+
+		static constexpr size_t wrap(size_t pIndex) {
+			if constexpr (std::has_single_bit(N)) {
+				return pIndex & (N - 1);
+			} else {
+				return pIndex % N;
+			}
+		}
+
+		constexpr T& pushOne() {
+			T& elem = mData[wrap(mHead)];
+			++mHead;
+			if (mSize < N) ++mSize;
+			return elem;
+		}
 	};
 } // namespace ArcdpsExtension
 
 // test if the range is also valid
 static_assert(std::ranges::random_access_range<ArcdpsExtension::RingBuffer<uint64_t>>);
 static_assert(std::ranges::random_access_range<const ArcdpsExtension::RingBuffer<uint64_t>>);
+static_assert(std::ranges::random_access_range<ArcdpsExtension::MaskedRingBuffer<uint64_t>>);
+static_assert(std::ranges::random_access_range<const ArcdpsExtension::MaskedRingBuffer<uint64_t>>);
+static_assert(std::ranges::random_access_range<ArcdpsExtension::StaticRingBuffer<uint64_t, 8>>);
+static_assert(std::ranges::random_access_range<const ArcdpsExtension::StaticRingBuffer<uint64_t, 8>>);
 
 template<typename T, typename Allocator>
 void ArcdpsExtension::RingBuffer<T, Allocator>::PushBack(T&& pElement) {
@@ -296,6 +651,64 @@ void ArcdpsExtension::RingBuffer<T, Allocator>::PushBack(const T& pElement) {
 	new (elem) T(pElement);
 }
 
+template<typename T, typename Allocator>
+void ArcdpsExtension::RingBuffer<T, Allocator>::PushBack(std::span<const T> pElements) {
+	if constexpr (std::is_trivially_copyable_v<T>) {
+		const size_t capacity = mCapacityEnd - mCapacityBegin;
+		if (capacity == 0) return;
+		if (pElements.size() > capacity) {
+			// everything in front is pushed one by one, so it still reaches OnEvict
+			if (mNotifyEvict) {
+				for (const T& element : pElements.first(pElements.size() - capacity)) {
+					PushBack(element);
+				}
+			}
+			pElements = pElements.last(capacity);
+		}
+
+		// fill the unused capacity first
+		if (mSizeEnd != mCapacityEnd) {
+			const size_t count = std::min<size_t>(pElements.size(), mCapacityEnd - mSizeEnd);
+			std::memcpy(mSizeEnd, pElements.data(), count * sizeof(T));
+			mSizeEnd += count;
+			pElements = pElements.subspan(count);
+		}
+
+		// overwrite the oldest elements, starting at mCurrent
+		if (!pElements.empty()) {
+			if (mNotifyEvict) {
+				T* evict = mCurrent;
+				for (size_t i = 0; i < pElements.size(); ++i) {
+					OnEvict(*evict);
+					evict = advance(evict);
+				}
+			}
+
+			const size_t first = std::min<size_t>(pElements.size(), mCapacityEnd - mCurrent);
+			std::memcpy(mCurrent, pElements.data(), first * sizeof(T));
+			const size_t second = pElements.size() - first;
+			std::memcpy(mCapacityBegin, pElements.data() + first, second * sizeof(T));
+			mCurrent += first;
+			if (mCurrent == mCapacityEnd) mCurrent = mCapacityBegin;
+			mCurrent += second;
+		}
+	} else {
+		for (const T& element : pElements) {
+			PushBack(element);
+		}
+	}
+}
+
+template<typename T, typename Allocator>
+std::array<std::span<T>, 2> ArcdpsExtension::RingBuffer<T, Allocator>::Segments() {
+	return {std::span<T>(mCurrent, mSizeEnd), std::span<T>(mCapacityBegin, mCurrent)};
+}
+
+template<typename T, typename Allocator>
+std::array<std::span<const T>, 2> ArcdpsExtension::RingBuffer<T, Allocator>::Segments() const {
+	return {std::span<const T>(mCurrent, mSizeEnd), std::span<const T>(mCapacityBegin, mCurrent)};
+}
+
 template<typename T, typename Allocator>
 T* ArcdpsExtension::RingBuffer<T, Allocator>::pushOne() {
 	// If first element
@@ -314,6 +727,9 @@ T* ArcdpsExtension::RingBuffer<T, Allocator>::pushOne() {
 	T* current = mCurrent;
 	mCurrent = advance(mCurrent);
 
+	if (mNotifyEvict) {
+		OnEvict(*current);
+	}
 	current->~T();
 	return current;
 }
@@ -398,12 +814,153 @@ void ArcdpsExtension::RingBuffer<T, Allocator>::Resize(size_t pNewCapacity) {
 
 template<typename T, typename Allocator>
 const T& ArcdpsExtension::RingBuffer<T, Allocator>::operator[](size_t pNum) const {
-	const auto var = begin() + pNum;
-	return *var;
+	return mCapacityBegin[index(pNum)];
 }
 
 template<typename T, typename Allocator>
 T& ArcdpsExtension::RingBuffer<T, Allocator>::operator[](size_t pNum) {
-	auto var = begin() + pNum;
-	return *var;
+	return mCapacityBegin[index(pNum)];
+}
+
+template<typename T, typename Allocator>
+size_t ArcdpsExtension::RingBuffer<T, Allocator>::index(size_t pNum) const {
+	// mCurrent is only moved when the buffer is full, so a single wrap is enough
+	size_t res = static_cast<size_t>(mCurrent - mCapacityBegin) + pNum;
+	const size_t size = Size();
+	if (res >= size) res -= size;
+	return res;
+}
+
+template<typename T, typename Allocator>
+void ArcdpsExtension::MaskedRingBuffer<T, Allocator>::PushBack(T&& pElement) {
+	T* elem = pushOne();
+	new (elem) T(std::move(pElement));
+}
+
+template<typename T, typename Allocator>
+void ArcdpsExtension::MaskedRingBuffer<T, Allocator>::PushBack(const T& pElement) {
+	T* elem = pushOne();
+	new (elem) T(pElement);
+}
+
+template<typename T, typename Allocator>
+void ArcdpsExtension::MaskedRingBuffer<T, Allocator>::PushBack(std::span<const T> pElements) {
+	if constexpr (std::is_trivially_copyable_v<T>) {
+		const size_t capacity = Capacity();
+		if (pElements.size() > capacity) {
+			pElements = pElements.last(capacity);
+		}
+
+		const size_t pos = mHead & mMask;
+		const size_t first = std::min(pElements.size(), capacity - pos);
+		std::memcpy(mData + pos, pElements.data(), first * sizeof(T));
+		std::memcpy(mData, pElements.data() + first, (pElements.size() - first) * sizeof(T));
+		mHead += pElements.size();
+		mSize = std::min(mSize + pElements.size(), capacity);
+	} else {
+		for (const T& element : pElements) {
+			PushBack(element);
+		}
+	}
+}
+
+template<typename T, typename Allocator>
+std::array<std::span<T>, 2> ArcdpsExtension::MaskedRingBuffer<T, Allocator>::Segments() {
+	const size_t start = (mHead - mSize) & mMask;
+	const size_t first = std::min(mSize, Capacity() - start);
+	return {std::span<T>(mData + start, first), std::span<T>(mData, mSize - first)};
+}
+
+template<typename T, typename Allocator>
+std::array<std::span<const T>, 2> ArcdpsExtension::MaskedRingBuffer<T, Allocator>::Segments() const {
+	const size_t start = (mHead - mSize) & mMask;
+	const size_t first = std::min(mSize, Capacity() - start);
+	return {std::span<const T>(mData + start, first), std::span<const T>(mData, mSize - first)};
+}
+
+template<typename T, typename Allocator>
+template<typename... Args>
+void ArcdpsExtension::MaskedRingBuffer<T, Allocator>::EmplaceBack(Args&&... args) {
+	T* elem = pushOne();
+	new (elem) T(std::forward<Args>(args)...);
+}
+
+template<typename T, typename Allocator>
+T& ArcdpsExtension::MaskedRingBuffer<T, Allocator>::Back() {
+	return mData[(mHead - 1) & mMask];
+}
+
+template<typename T, typename Allocator>
+const T& ArcdpsExtension::MaskedRingBuffer<T, Allocator>::Back() const {
+	return mData[(mHead - 1) & mMask];
+}
+
+template<typename T, typename Allocator>
+void ArcdpsExtension::MaskedRingBuffer<T, Allocator>::Clear() {
+	if constexpr (!std::is_trivially_destructible_v<T>) {
+		for (T& elem : *this) {
+			elem.~T();
+		}
+	}
+	mHead = 0;
+	mSize = 0;
+}
+
+template<typename T, typename Allocator>
+size_t ArcdpsExtension::MaskedRingBuffer<T, Allocator>::Size() const {
+	return mSize;
+}
+
+template<typename T, typename Allocator>
+size_t ArcdpsExtension::MaskedRingBuffer<T, Allocator>::Capacity() const {
+	return mMask + 1;
+}
+
+template<typename T, typename Allocator>
+void ArcdpsExtension::MaskedRingBuffer<T, Allocator>::Resize(size_t pNewCapacity) {
+	MaskedRingBuffer resized(pNewCapacity, mAlloc);
+	// only the newest elements are kept, if the new capacity is smaller
+	for (T& elem : *this) {
+		resized.PushBack(std::move(elem));
+	}
+	swap(resized);
+}
+
+template<typename T, typename Allocator>
+const T& ArcdpsExtension::MaskedRingBuffer<T, Allocator>::operator[](size_t pNum) const {
+	return mData[(mHead - mSize + pNum) & mMask];
+}
+
+template<typename T, typename Allocator>
+T& ArcdpsExtension::MaskedRingBuffer<T, Allocator>::operator[](size_t pNum) {
+	return mData[(mHead - mSize + pNum) & mMask];
+}
+
+template<typename T, typename Allocator>
+void ArcdpsExtension::MaskedRingBuffer<T, Allocator>::allocate(size_t pCapacity) {
+	const size_t capacity = std::bit_ceil(pCapacity == 0 ? size_t{1} : pCapacity);
+	mData = mAlloc.allocate(capacity);
+	mMask = capacity - 1;
+}
+
+template<typename T, typename Allocator>
+T* ArcdpsExtension::MaskedRingBuffer<T, Allocator>::pushOne() {
+	T* elem = mData + (mHead & mMask);
+	if (mSize > mMask) {
+		// full, overwrite the oldest
+		elem->~T();
+	} else {
+		++mSize;
+	}
+	++mHead;
+	return elem;
+}
+
+template<typename T, typename Allocator>
+void ArcdpsExtension::MaskedRingBuffer<T, Allocator>::swap(MaskedRingBuffer& pOther) noexcept {
+	std::swap(mData, pOther.mData);
+	std::swap(mMask, pOther.mMask);
+	std::swap(mHead, pOther.mHead);
+	std::swap(mSize, pOther.mSize);
+	std::swap(mAlloc, pOther.mAlloc);
 }
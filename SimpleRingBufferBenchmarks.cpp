@@ -0,0 +1,165 @@
+#include "arcdps_structs_slim.h"
+#include "SimpleRingBuffer.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+using namespace ArcdpsExtension;
+
+namespace {
+	/**
+	 * `std::deque` with the overwriting behavior of `RingBuffer`, as reference.
+	 */
+	template<typename T>
+	class DequeRingBuffer {
+	public:
+		explicit DequeRingBuffer(size_t pCapacity) : mCapacity(pCapacity) {}
+
+		void PushBack(const T& pElement) {
+			if (mData.size() == mCapacity) {
+				mData.pop_front();
+			}
+			mData.push_back(pElement);
+		}
+
+		void Resize(size_t pNewCapacity) {
+			while (mData.size() > pNewCapacity) {
+				mData.pop_front();
+			}
+			mCapacity = pNewCapacity;
+		}
+
+		[[nodiscard]] size_t Size() const { return mData.size(); }
+		const T& operator[](size_t pNum) const { return mData[pNum]; }
+		auto begin() const { return mData.begin(); }
+		auto end() const { return mData.end(); }
+
+	private:
+		size_t mCapacity;
+		std::deque<T> mData;
+	};
+
+	template<typename T>
+	T MakeValue(uint64_t pNum);
+
+	template<>
+	uint64_t MakeValue<uint64_t>(uint64_t pNum) {
+		return pNum;
+	}
+
+	template<>
+	cbtevent MakeValue<cbtevent>(uint64_t pNum) {
+		cbtevent event{};
+		event.time = pNum;
+		event.value = static_cast<int32_t>(pNum);
+		return event;
+	}
+
+	template<>
+	std::string MakeValue<std::string>(uint64_t pNum) {
+		// longer than the small string buffer, so every element has its own allocation
+		return std::string(40, static_cast<char>('a' + pNum % 26));
+	}
+
+	uint64_t Key(uint64_t pValue) { return pValue; }
+	uint64_t Key(const cbtevent& pValue) { return pValue.time; }
+	uint64_t Key(const std::string& pValue) { return static_cast<uint64_t>(pValue[0]); }
+
+	/**
+	 * Filled above capacity, so the content wraps around.
+	 */
+	template<typename Buffer, typename T>
+	Buffer MakeFull(size_t pCapacity) {
+		Buffer buffer(pCapacity);
+		for (uint64_t i = 0; i < pCapacity + pCapacity / 3; ++i) {
+			buffer.PushBack(MakeValue<T>(i));
+		}
+		return buffer;
+	}
+
+	void SetPerOp(benchmark::State& pState, int64_t pOpsPerIteration) {
+		pState.SetItemsProcessed(pState.iterations() * pOpsPerIteration);
+		pState.counters["per_op"] = benchmark::Counter(static_cast<double>(pState.iterations() * pOpsPerIteration), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+	}
+
+	template<typename Buffer, typename T>
+	void PushOverwrite(benchmark::State& pState) {
+		auto buffer = MakeFull<Buffer, T>(1024);
+		const T value = MakeValue<T>(42);
+		for (auto _ : pState) {
+			buffer.PushBack(value);
+			benchmark::ClobberMemory();
+		}
+		SetPerOp(pState, 1);
+	}
+
+	template<typename Buffer, typename T>
+	void Iterate(benchmark::State& pState) {
+		const auto size = static_cast<size_t>(pState.range(0));
+		const auto buffer = MakeFull<Buffer, T>(size);
+		for (auto _ : pState) {
+			uint64_t sum = 0;
+			for (const T& element : buffer) {
+				sum += Key(element);
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		SetPerOp(pState, static_cast<int64_t>(size));
+	}
+
+	/**
+	 * Walks with a fixed stride (in elements), bigger strides miss the cache on every access.
+	 */
+	template<typename Buffer, typename T>
+	void RandomAccess(benchmark::State& pState) {
+		const auto size = static_cast<size_t>(pState.range(0));
+		const auto stride = static_cast<size_t>(pState.range(1));
+		const auto buffer = MakeFull<Buffer, T>(size);
+		size_t index = 0;
+		for (auto _ : pState) {
+			uint64_t sum = 0;
+			for (size_t i = 0; i < 1024; ++i) {
+				sum += Key(buffer[index]);
+				index += stride;
+				if (index >= size) index -= size;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		SetPerOp(pState, 1024);
+	}
+
+	template<typename Buffer, typename T>
+	void Resize(benchmark::State& pState) {
+		const auto size = static_cast<size_t>(pState.range(0));
+		for (auto _ : pState) {
+			pState.PauseTiming();
+			auto buffer = MakeFull<Buffer, T>(size);
+			pState.ResumeTiming();
+
+			buffer.Resize(size / 2);
+			buffer.Resize(size);
+			benchmark::DoNotOptimize(buffer);
+		}
+		SetPerOp(pState, static_cast<int64_t>(size));
+	}
+} // namespace
+
+#define RING_BUFFER_BENCHMARKS(Type)                                                                                                \
+	BENCHMARK_TEMPLATE(PushOverwrite, RingBuffer<Type>, Type);                                                                      \
+	BENCHMARK_TEMPLATE(PushOverwrite, MaskedRingBuffer<Type>, Type);                                                                \
+	BENCHMARK_TEMPLATE(PushOverwrite, DequeRingBuffer<Type>, Type);                                                                 \
+	BENCHMARK_TEMPLATE(Iterate, RingBuffer<Type>, Type)->Arg(1 << 10)->Arg(1 << 16);                                                \
+	BENCHMARK_TEMPLATE(Iterate, MaskedRingBuffer<Type>, Type)->Arg(1 << 10)->Arg(1 << 16);                                          \
+	BENCHMARK_TEMPLATE(Iterate, DequeRingBuffer<Type>, Type)->Arg(1 << 10)->Arg(1 << 16);                                           \
+	BENCHMARK_TEMPLATE(RandomAccess, RingBuffer<Type>, Type)->ArgsProduct({{1 << 16}, {1, 17, 4099}});                              \
+	BENCHMARK_TEMPLATE(RandomAccess, MaskedRingBuffer<Type>, Type)->ArgsProduct({{1 << 16}, {1, 17, 4099}});                        \
+	BENCHMARK_TEMPLATE(RandomAccess, DequeRingBuffer<Type>, Type)->ArgsProduct({{1 << 16}, {1, 17, 4099}});                         \
+	BENCHMARK_TEMPLATE(Resize, RingBuffer<Type>, Type)->Arg(1 << 12);                                                               \
+	BENCHMARK_TEMPLATE(Resize, MaskedRingBuffer<Type>, Type)->Arg(1 << 12);                                                         \
+	BENCHMARK_TEMPLATE(Resize, DequeRingBuffer<Type>, Type)->Arg(1 << 12)
+
+RING_BUFFER_BENCHMARKS(uint64_t);
+RING_BUFFER_BENCHMARKS(cbtevent);
+RING_BUFFER_BENCHMARKS(std::string);
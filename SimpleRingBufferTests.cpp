@@ -4,6 +4,10 @@
 #include <cstdint>
 #include <gtest/gtest.h>
 #include <ranges>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 using namespace ArcdpsExtension;
@@ -317,3 +321,305 @@ TEST(SimpleRingBufferTests, IteratorOrderingTest) {
 	EXPECT_LT(buffer.begin(), buffer.end());
 	EXPECT_LT(buffer.begin() + 1, buffer.end() - 1);
 }
+
+TEST(SimpleRingBufferTests, RandomAccessWrappedTest) {
+	RingBuffer<uint64_t> buffer(4);
+	for (uint64_t i = 0; i < 3; ++i) {
+		buffer.PushBack(i);
+	}
+	// not full, nothing wrapped
+	EXPECT_EQ(buffer[0], 0);
+	EXPECT_EQ(buffer[2], 2);
+
+	for (uint64_t i = 3; i < 11; ++i) {
+		buffer.PushBack(i);
+		for (size_t j = 0; j < buffer.Size(); ++j) {
+			EXPECT_EQ(buffer[j], i - 3 + j);
+		}
+	}
+}
+
+TEST(SimpleRingBufferTests, MaskedPushBackTest) {
+	MaskedRingBuffer<uint64_t> buffer(10);
+	EXPECT_EQ(buffer.Capacity(), 16);
+
+	for (uint64_t i = 1; i < 7; ++i) {
+		buffer.PushBack(i);
+		EXPECT_EQ(buffer.Back(), i);
+	}
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{1, 2, 3, 4, 5, 6}));
+
+	for (uint64_t i = 7; i < 21; ++i) {
+		buffer.EmplaceBack(i);
+		EXPECT_EQ(buffer.Back(), i);
+	}
+	EXPECT_EQ(buffer.Size(), 16);
+	EXPECT_EQ(buffer[0], 5);
+	EXPECT_EQ(buffer[15], 20);
+	EXPECT_TRUE(std::ranges::equal(buffer | std::ranges::views::reverse | std::ranges::views::take(3), std::vector<uint64_t>{20, 19, 18}));
+
+	buffer.Clear();
+	EXPECT_EQ(buffer.Size(), 0);
+	EXPECT_EQ(buffer.begin(), buffer.end());
+}
+
+TEST(SimpleRingBufferTests, MaskedResizeTest) {
+	MaskedRingBuffer<uint64_t> buffer(8);
+	for (uint64_t i = 1; i < 15; ++i) {
+		buffer.PushBack(i);
+	}
+
+	buffer.Resize(4);
+	EXPECT_EQ(buffer.Capacity(), 4);
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{11, 12, 13, 14}));
+
+	buffer.Resize(16);
+	buffer.PushBack(15);
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{11, 12, 13, 14, 15}));
+
+	// copy and move
+	const MaskedRingBuffer<uint64_t> copy = buffer;
+	MaskedRingBuffer<uint64_t> moved = std::move(buffer);
+	EXPECT_TRUE(std::ranges::equal(copy, moved));
+}
+
+namespace {
+	// stateful allocator, counts the live allocations of its arena
+	template<typename T>
+	struct CountingAllocator {
+		using value_type = T;
+
+		size_t* mAllocations;
+
+		explicit CountingAllocator(size_t* pAllocations) : mAllocations(pAllocations) {}
+		template<typename U>
+		CountingAllocator(const CountingAllocator<U>& pOther) : mAllocations(pOther.mAllocations) {}
+
+		T* allocate(size_t pCount) {
+			++*mAllocations;
+			return std::allocator<T>().allocate(pCount);
+		}
+
+		void deallocate(T* pPointer, size_t pCount) {
+			--*mAllocations;
+			std::allocator<T>().deallocate(pPointer, pCount);
+		}
+
+		bool operator==(const CountingAllocator& pOther) const = default;
+	};
+} // namespace
+
+TEST(SimpleRingBufferTests, MaskedResizeAllocatorTest) {
+	size_t allocations = 0;
+	{
+		MaskedRingBuffer<uint64_t, CountingAllocator<uint64_t>> buffer(4, CountingAllocator<uint64_t>(&allocations));
+		EXPECT_EQ(allocations, 1);
+		buffer.PushBack(1);
+
+		// the new storage comes from the same allocator
+		buffer.Resize(16);
+		EXPECT_EQ(allocations, 1);
+		EXPECT_EQ(buffer.Capacity(), 16);
+		EXPECT_EQ(buffer.Back(), 1);
+	}
+	EXPECT_EQ(allocations, 0);
+}
+
+TEST(SimpleRingBufferTests, MaskedAlgorithmTest) {
+	MaskedRingBuffer<uint64_t> buffer(8);
+	for (uint64_t value : {9, 3, 7, 1, 8, 2, 6, 4, 5, 0}) {
+		buffer.PushBack(value);
+	}
+	// oldest two are overwritten
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{7, 1, 8, 2, 6, 4, 5, 0}));
+
+	std::ranges::sort(buffer);
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{0, 1, 2, 4, 5, 6, 7, 8}));
+
+	const auto& constBuffer = buffer;
+	const auto it = std::ranges::lower_bound(constBuffer, 3);
+	EXPECT_EQ(it - constBuffer.begin(), 3);
+	EXPECT_EQ(*it, 4);
+}
+
+TEST(SimpleRingBufferTests, MaskedNonTrivialTest) {
+	MaskedRingBuffer<std::string> buffer(2);
+	buffer.EmplaceBack(3, 'a');
+	buffer.PushBack("b");
+	buffer.PushBack(std::string("c"));
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<std::string>{"b", "c"}));
+}
+
+TEST(SimpleRingBufferTests, SegmentsTest) {
+	RingBuffer<uint64_t> buffer(5);
+	auto segments = std::as_const(buffer).Segments();
+	EXPECT_TRUE(segments[0].empty());
+	EXPECT_TRUE(segments[1].empty());
+
+	for (uint64_t i = 1; i < 4; ++i) {
+		buffer.PushBack(i);
+	}
+	segments = std::as_const(buffer).Segments();
+	EXPECT_TRUE(std::ranges::equal(segments[0], std::vector<uint64_t>{1, 2, 3}));
+	EXPECT_TRUE(segments[1].empty());
+
+	for (uint64_t i = 4; i < 8; ++i) {
+		buffer.PushBack(i);
+	}
+	segments = std::as_const(buffer).Segments();
+	EXPECT_TRUE(std::ranges::equal(segments[0], std::vector<uint64_t>{3, 4, 5}));
+	EXPECT_TRUE(std::ranges::equal(segments[1], std::vector<uint64_t>{6, 7}));
+
+	// writable
+	for (auto segment : buffer.Segments()) {
+		for (uint64_t& value : segment) {
+			value *= 2;
+		}
+	}
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{6, 8, 10, 12, 14}));
+}
+
+TEST(SimpleRingBufferTests, BulkPushBackTest) {
+	// compare with single PushBack calls for all chunk sizes
+	for (size_t chunk = 1; chunk < 12; ++chunk) {
+		RingBuffer<uint64_t> expected(7);
+		RingBuffer<uint64_t> buffer(7);
+		MaskedRingBuffer<uint64_t> masked(8);
+		MaskedRingBuffer<uint64_t> maskedExpected(8);
+
+		std::vector<uint64_t> values;
+		uint64_t next = 0;
+		for (int round = 0; round < 5; ++round) {
+			values.clear();
+			for (size_t i = 0; i < chunk; ++i) {
+				values.push_back(next++);
+			}
+			for (uint64_t value : values) {
+				expected.PushBack(value);
+				maskedExpected.PushBack(value);
+			}
+			buffer.PushBack(std::span<const uint64_t>(values));
+			masked.PushBack(std::span<const uint64_t>(values));
+
+			EXPECT_TRUE(std::ranges::equal(buffer, expected)) << "chunk " << chunk << " round " << round;
+			EXPECT_TRUE(std::ranges::equal(masked, maskedExpected)) << "chunk " << chunk << " round " << round;
+			EXPECT_EQ(buffer.Back(), expected.Back());
+		}
+
+		// segments cover the same elements
+		std::vector<uint64_t> joined;
+		for (auto segment : masked.Segments()) {
+			joined.insert(joined.end(), segment.begin(), segment.end());
+		}
+		EXPECT_TRUE(std::ranges::equal(joined, maskedExpected));
+	}
+}
+
+TEST(SimpleRingBufferTests, BulkPushBackNonTrivialTest) {
+	RingBuffer<std::string> buffer(2);
+	const std::vector<std::string> values{"a", "b", "c"};
+	buffer.PushBack(std::span<const std::string>(values));
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<std::string>{"b", "c"}));
+}
+
+namespace {
+	constexpr uint64_t StaticRingBufferSum() {
+		StaticRingBuffer<uint64_t, 3> buffer;
+		for (uint64_t i = 1; i < 6; ++i) {
+			buffer.PushBack(i);
+		}
+		uint64_t sum = 0;
+		for (uint64_t value : buffer) {
+			sum += value;
+		}
+		return sum;
+	}
+} // namespace
+
+// works at compile time, with a capacity that is not a power of two
+static_assert(StaticRingBufferSum() == 3 + 4 + 5);
+static_assert(std::is_trivially_copyable_v<StaticRingBuffer<uint64_t, 8>::iterator>);
+
+TEST(SimpleRingBufferTests, StaticPushBackTest) {
+	StaticRingBuffer<uint64_t, 10> buffer;
+	EXPECT_EQ(buffer.Capacity(), 10);
+	for (uint64_t i = 1; i < 7; ++i) {
+		buffer.PushBack(i);
+		EXPECT_EQ(buffer.Back(), i);
+	}
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{1, 2, 3, 4, 5, 6}));
+
+	for (uint64_t i = 7; i < 15; ++i) {
+		buffer.EmplaceBack(i);
+	}
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{5, 6, 7, 8, 9, 10, 11, 12, 13, 14}));
+	EXPECT_EQ(buffer[0], 5);
+	EXPECT_EQ(buffer[9], 14);
+
+	const auto segments = std::as_const(buffer).Segments();
+	EXPECT_TRUE(std::ranges::equal(segments[0], std::vector<uint64_t>{5, 6, 7, 8, 9, 10}));
+	EXPECT_TRUE(std::ranges::equal(segments[1], std::vector<uint64_t>{11, 12, 13, 14}));
+
+	buffer.Clear();
+	EXPECT_EQ(buffer.Size(), 0);
+}
+
+TEST(SimpleRingBufferTests, StaticMaskedTest) {
+	StaticRingBuffer<uint64_t, 8> buffer;
+	const std::vector<uint64_t> values{9, 3, 7, 1, 8, 2, 6, 4, 5, 0};
+	buffer.PushBack(std::span<const uint64_t>(values));
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{7, 1, 8, 2, 6, 4, 5, 0}));
+
+	std::ranges::sort(buffer);
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{0, 1, 2, 4, 5, 6, 7, 8}));
+	EXPECT_TRUE(std::ranges::equal(buffer | std::ranges::views::reverse | std::ranges::views::take(2), std::vector<uint64_t>{8, 7}));
+
+	// copies are independent
+	auto copy = buffer;
+	copy.PushBack(100);
+	EXPECT_EQ(buffer.Back(), 8);
+	EXPECT_EQ(copy.Back(), 100);
+}
+
+TEST(SimpleRingBufferTests, StaticNonTrivialTest) {
+	StaticRingBuffer<std::string, 2> buffer;
+	buffer.EmplaceBack(3, 'a');
+	buffer.PushBack("b");
+	buffer.PushBack(std::string("c"));
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<std::string>{"b", "c"}));
+	buffer.Clear();
+	EXPECT_EQ(buffer.begin(), buffer.end());
+}
+
+namespace {
+	class EvictRecorder : public RingBuffer<uint64_t> {
+	public:
+		explicit EvictRecorder(size_t pCapacity) : RingBuffer(pCapacity) {
+			EnableOnEvict();
+		}
+
+		std::vector<uint64_t> Evicted;
+
+	protected:
+		void OnEvict(uint64_t& pElement) override {
+			Evicted.push_back(pElement);
+		}
+	};
+} // namespace
+
+TEST(SimpleRingBufferTests, OnEvictTest) {
+	EvictRecorder buffer(3);
+	for (uint64_t i = 1; i < 6; ++i) {
+		buffer.PushBack(i);
+	}
+	EXPECT_EQ(buffer.Evicted, (std::vector<uint64_t>{1, 2}));
+
+	// bulk push evicts the same elements as single pushes
+	const std::vector<uint64_t> values{6, 7, 8, 9};
+	buffer.PushBack(std::span<const uint64_t>(values));
+	EXPECT_EQ(buffer.Evicted, (std::vector<uint64_t>{1, 2, 3, 4, 5, 6}));
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{7, 8, 9}));
+
+	buffer.Clear();
+	EXPECT_EQ(buffer.Evicted.size(), 6);
+}
@@ -0,0 +1,177 @@
+#include "SkillTable.h"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+
+namespace {
+	constexpr std::array<char, 4> SKILL_TABLE_MAGIC = {'A', 'S', 'K', 'T'};
+	constexpr uint32_t SKILL_TABLE_VERSION = 1;
+
+	template<typename T>
+	void WriteValue(std::ostream& pStream, const T& pValue) {
+		pStream.write(reinterpret_cast<const char*>(&pValue), sizeof(T));
+	}
+
+	template<typename T>
+	bool ReadValue(std::istream& pStream, T& pValue) {
+		pStream.read(reinterpret_cast<char*>(&pValue), sizeof(T));
+		return pStream.good();
+	}
+} // namespace
+
+ArcdpsExtension::SkillIndex ArcdpsExtension::SkillTable::Observe(uint32_t pSkillId, const char* pSkillname) {
+	// Only this thread writes, so reading without the lock is fine here.
+	SkillIndex index = indexOf(pSkillId);
+	if (index != InvalidIndex) {
+		if (pSkillname != nullptr && pSkillname[0] != '\0' && mSkills[index].Name.empty()) {
+			std::unique_lock guard(mMutex);
+			mSkills[index].Name = pSkillname;
+		}
+		return index;
+	}
+
+	std::unique_lock guard(mMutex);
+	return insert(pSkillId, pSkillname != nullptr ? std::string_view(pSkillname) : std::string_view());
+}
+
+ArcdpsExtension::SkillIndex ArcdpsExtension::SkillTable::IndexOf(uint32_t pSkillId) const {
+	std::shared_lock guard(mMutex);
+	return indexOf(pSkillId);
+}
+
+std::optional<ArcdpsExtension::SkillInfo> ArcdpsExtension::SkillTable::Find(uint32_t pSkillId) const {
+	std::shared_lock guard(mMutex);
+	SkillIndex index = indexOf(pSkillId);
+	if (index == InvalidIndex) {
+		return std::nullopt;
+	}
+	return mSkills[index];
+}
+
+ArcdpsExtension::SkillInfo ArcdpsExtension::SkillTable::At(SkillIndex pIndex) const {
+	std::shared_lock guard(mMutex);
+	return mSkills[pIndex];
+}
+
+size_t ArcdpsExtension::SkillTable::Size() const {
+	std::shared_lock guard(mMutex);
+	return mSkills.size();
+}
+
+bool ArcdpsExtension::SkillTable::SetIconKey(uint32_t pSkillId, uint64_t pIconKey) {
+	std::unique_lock guard(mMutex);
+	SkillIndex index = indexOf(pSkillId);
+	if (index == InvalidIndex) {
+		return false;
+	}
+	mSkills[index].IconKey = pIconKey;
+	return true;
+}
+
+bool ArcdpsExtension::SkillTable::SetCategory(uint32_t pSkillId, uint32_t pCategory) {
+	std::unique_lock guard(mMutex);
+	SkillIndex index = indexOf(pSkillId);
+	if (index == InvalidIndex) {
+		return false;
+	}
+	mSkills[index].Category = pCategory;
+	return true;
+}
+
+void ArcdpsExtension::SkillTable::Export(std::ostream& pStream) const {
+	std::shared_lock guard(mMutex);
+
+	pStream.write(SKILL_TABLE_MAGIC.data(), SKILL_TABLE_MAGIC.size());
+	WriteValue(pStream, SKILL_TABLE_VERSION);
+	WriteValue(pStream, static_cast<uint32_t>(mSkills.size()));
+
+	for (const auto& skill : mSkills) {
+		const auto nameLength = static_cast<uint16_t>(std::min<size_t>(skill.Name.size(), UINT16_MAX));
+		WriteValue(pStream, skill.Id);
+		WriteValue(pStream, skill.Category);
+		WriteValue(pStream, skill.IconKey);
+		WriteValue(pStream, nameLength);
+		pStream.write(skill.Name.data(), nameLength);
+	}
+}
+
+bool ArcdpsExtension::SkillTable::Import(std::istream& pStream) {
+	std::array<char, 4> magic{};
+	uint32_t version = 0;
+	uint32_t count = 0;
+	pStream.read(magic.data(), magic.size());
+	if (!pStream.good() || magic != SKILL_TABLE_MAGIC) {
+		return false;
+	}
+	if (!ReadValue(pStream, version) || version != SKILL_TABLE_VERSION) {
+		return false;
+	}
+	if (!ReadValue(pStream, count)) {
+		return false;
+	}
+
+	std::unique_lock guard(mMutex);
+	for (uint32_t i = 0; i < count; ++i) {
+		SkillInfo info;
+		uint16_t nameLength = 0;
+		if (!ReadValue(pStream, info.Id) || !ReadValue(pStream, info.Category) || !ReadValue(pStream, info.IconKey) || !ReadValue(pStream, nameLength)) {
+			return false;
+		}
+
+		std::string name(nameLength, '\0');
+		pStream.read(name.data(), nameLength);
+		if (pStream.gcount() != nameLength) {
+			return false;
+		}
+
+		SkillIndex index = indexOf(info.Id);
+		if (index == InvalidIndex) {
+			index = insert(info.Id, {});
+		}
+		SkillInfo& skill = mSkills[index];
+		if (skill.Name.empty() && !name.empty()) {
+			skill.Name = mNameStorage.emplace_back(std::move(name));
+		}
+		skill.IconKey = info.IconKey;
+		skill.Category = info.Category;
+	}
+
+	return true;
+}
+
+ArcdpsExtension::SkillIndex ArcdpsExtension::SkillTable::indexOf(uint32_t pSkillId) const {
+	if (pSkillId >= MaxDirectId) {
+		const auto it = mOverflow.find(pSkillId);
+		return it != mOverflow.end() ? it->second : InvalidIndex;
+	}
+
+	const uint32_t pageIndex = pSkillId >> PageBits;
+	if (pageIndex >= mPages.size() || !mPages[pageIndex]) {
+		return InvalidIndex;
+	}
+	return (*mPages[pageIndex])[pSkillId & (PageSize - 1)];
+}
+
+ArcdpsExtension::SkillIndex ArcdpsExtension::SkillTable::insert(uint32_t pSkillId, std::string_view pName) {
+	const auto index = static_cast<SkillIndex>(mSkills.size());
+	mSkills.push_back(SkillInfo{pSkillId, pName});
+
+	if (pSkillId >= MaxDirectId) {
+		mOverflow.emplace(pSkillId, index);
+		return index;
+	}
+
+	const uint32_t pageIndex = pSkillId >> PageBits;
+	if (pageIndex >= mPages.size()) {
+		mPages.resize(pageIndex + 1);
+	}
+	auto& page = mPages[pageIndex];
+	if (!page) {
+		page = std::make_unique<Page>();
+		page->fill(InvalidIndex);
+	}
+
+	(*page)[pSkillId & (PageSize - 1)] = index;
+	return index;
+}
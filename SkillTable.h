@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ArcdpsExtension {
+	using SkillIndex = uint32_t;
+
+	/**
+	 * Metadata of a single skill. `IconKey` and `Category` are free slots for the plugin, they are never set by this class.
+	 */
+	struct SkillInfo {
+		uint32_t Id = 0;
+		std::string_view Name; // arcdps skill names are valid for the lifetime of the process, imported names are owned by the table
+		uint64_t IconKey = 0;
+		uint32_t Category = 0;
+	};
+
+	/**
+	 * Dense table of all skills seen so far.
+	 * Every skill gets a compact `SkillIndex` on first sighting, that can be used to index own vectors instead of hashing names or ids.
+	 * Lookup by skill id is O(1) through a paged direct index (ids above `MaxDirectId` fall back to a hash map).
+	 * <br>
+	 * `Observe()` and `Import()` add skills and have to be called from the same thread (the event thread), or `Import()` has to be done before events are processed.
+	 * Every other function can be called from any thread.
+	 * <br>
+	 * Usage:
+	 * @code
+	 * SkillIndex index = skillTable.Observe(pEvent->skillid, pSkillname);
+	 * mDamagePerSkill[index] += pEvent->value;
+	 * @endcode
+	 */
+	class SkillTable {
+	public:
+		static constexpr SkillIndex InvalidIndex = std::numeric_limits<SkillIndex>::max();
+		static constexpr uint32_t MaxDirectId = 1 << 20;
+
+		SkillTable() = default;
+
+		// delete copy and move
+		SkillTable(const SkillTable& pOther) = delete;
+		SkillTable(SkillTable&& pOther) noexcept = delete;
+		SkillTable& operator=(const SkillTable& pOther) = delete;
+		SkillTable& operator=(SkillTable&& pOther) noexcept = delete;
+
+		/**
+		 * Add the skill if it is not known yet. Missing names are filled in later, when a sighting with a name happens.
+		 * @param pSkillId The skillid of the event
+		 * @param pSkillname The skillname as given by arcdps (has to be valid for the lifetime of the process), can be `nullptr`
+		 * @return The compact index of the skill
+		 */
+		SkillIndex Observe(uint32_t pSkillId, const char* pSkillname);
+
+		/**
+		 * @return The compact index of the skill or `InvalidIndex` if it was never seen.
+		 */
+		[[nodiscard]] SkillIndex IndexOf(uint32_t pSkillId) const;
+
+		[[nodiscard]] std::optional<SkillInfo> Find(uint32_t pSkillId) const;
+
+		/**
+		 * @param pIndex has to be smaller than `Size()`
+		 */
+		[[nodiscard]] SkillInfo At(SkillIndex pIndex) const;
+
+		[[nodiscard]] size_t Size() const;
+
+		/**
+		 * @return `false` if the skill is not known.
+		 */
+		bool SetIconKey(uint32_t pSkillId, uint64_t pIconKey);
+
+		/**
+		 * @return `false` if the skill is not known.
+		 */
+		bool SetCategory(uint32_t pSkillId, uint32_t pCategory);
+
+		/**
+		 * Write all skills in a compact binary format.
+		 * Load it with `Import()` on the next startup to have names and metadata before the first event is seen.
+		 */
+		void Export(std::ostream& pStream) const;
+
+		/**
+		 * Read skills written with `Export()`. Skills that are already known keep their name, but get the imported metadata.
+		 * @return `false` if the stream is not a valid skill table. Skills read before the error are kept.
+		 */
+		bool Import(std::istream& pStream);
+
+	private:
+		static constexpr uint32_t PageBits = 10;
+		static constexpr uint32_t PageSize = 1 << PageBits;
+		using Page = std::array<SkillIndex, PageSize>;
+
+		std::vector<SkillInfo> mSkills;
+		std::vector<std::unique_ptr<Page>> mPages;
+		std::unordered_map<uint32_t, SkillIndex> mOverflow;
+		std::deque<std::string> mNameStorage;
+		mutable std::shared_mutex mMutex;
+
+		[[nodiscard]] SkillIndex indexOf(uint32_t pSkillId) const;
+		SkillIndex insert(uint32_t pSkillId, std::string_view pName);
+	};
+} // namespace ArcdpsExtension
@@ -0,0 +1,81 @@
+#include "SkillTable.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace ArcdpsExtension;
+
+TEST(SkillTableTests, Observe) {
+	SkillTable table;
+	EXPECT_EQ(table.IndexOf(1122), SkillTable::InvalidIndex);
+
+	EXPECT_EQ(table.Observe(1122, "Blood Is Power"), 0);
+	EXPECT_EQ(table.Observe(30273, "Alacrity"), 1);
+	EXPECT_EQ(table.Observe(1122, "Blood Is Power"), 0);
+	EXPECT_EQ(table.Size(), 2);
+
+	EXPECT_EQ(table.IndexOf(30273), 1);
+	auto info = table.Find(30273);
+	ASSERT_TRUE(info.has_value());
+	EXPECT_EQ(info->Id, 30273);
+	EXPECT_EQ(info->Name, "Alacrity");
+	EXPECT_FALSE(table.Find(5).has_value());
+
+	EXPECT_EQ(table.At(0).Name, "Blood Is Power");
+}
+
+TEST(SkillTableTests, NameFilledLater) {
+	SkillTable table;
+	EXPECT_EQ(table.Observe(740, nullptr), 0);
+	EXPECT_EQ(table.At(0).Name, "");
+
+	EXPECT_EQ(table.Observe(740, "Might"), 0);
+	EXPECT_EQ(table.At(0).Name, "Might");
+}
+
+TEST(SkillTableTests, Metadata) {
+	SkillTable table;
+	EXPECT_FALSE(table.SetIconKey(740, 5));
+
+	table.Observe(740, "Might");
+	EXPECT_TRUE(table.SetIconKey(740, 5));
+	EXPECT_TRUE(table.SetCategory(740, 2));
+	EXPECT_EQ(table.At(0).IconKey, 5);
+	EXPECT_EQ(table.At(0).Category, 2);
+}
+
+TEST(SkillTableTests, ExportImport) {
+	std::stringstream stream;
+	{
+		SkillTable table;
+		table.Observe(740, "Might");
+		table.Observe(UINT32_MAX - 1, "Big Id");
+		table.SetIconKey(740, 5);
+		table.SetCategory(740, 2);
+		table.Export(stream);
+	}
+
+	SkillTable table;
+	table.Observe(1122, "Blood Is Power");
+	ASSERT_TRUE(table.Import(stream));
+
+	EXPECT_EQ(table.Size(), 3);
+	EXPECT_EQ(table.IndexOf(1122), 0);
+	EXPECT_EQ(table.IndexOf(740), 1);
+	EXPECT_EQ(table.IndexOf(UINT32_MAX - 1), 2);
+
+	auto might = table.Find(740);
+	ASSERT_TRUE(might.has_value());
+	EXPECT_EQ(might->Name, "Might");
+	EXPECT_EQ(might->IconKey, 5);
+	EXPECT_EQ(might->Category, 2);
+	EXPECT_EQ(table.At(2).Name, "Big Id");
+}
+
+TEST(SkillTableTests, ImportInvalid) {
+	SkillTable table;
+	std::stringstream stream("not a skill table");
+	EXPECT_FALSE(table.Import(stream));
+	EXPECT_EQ(table.Size(), 0);
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace ArcdpsExtension {
+	// fixed instead of std::hardware_destructive_interference_size, that one changes with compiler flags and would change the layout
+	inline constexpr size_t CacheLineSize = 64;
+
+	/**
+	 * Lock-free ring buffer for exactly one producer thread and one consumer thread.
+	 * Meant for the handoff between the arcdps combat thread and the ImGui render thread, without wrapping a `RingBuffer` in a mutex.
+	 * <br>
+	 * In contrast to `RingBuffer` this does not overwrite old elements, `PushBack()` fails when the buffer is full.
+	 * The capacity is rounded up to the next power of two.
+	 * <br>
+	 * Producer only: `PushBack()`, `EmplaceBack()`
+	 * Consumer only: `TryPop()`, `PopInto()`, `Clear()`, iteration
+	 * Both: `Size()`, `Empty()`, `Capacity()`
+	 *
+	 * @tparam T The type that this buffer holds.
+	 */
+	template<typename T, typename Allocator = std::allocator<T>>
+	class SpscRingBuffer {
+	public:
+		explicit SpscRingBuffer(size_t pCapacity)
+			: mCapacity(std::bit_ceil(pCapacity < 2 ? size_t{2} : pCapacity)),
+			  mMask(mCapacity - 1) {
+			mData = mAlloc.allocate(mCapacity);
+		}
+
+		~SpscRingBuffer() {
+			Clear();
+			mAlloc.deallocate(mData, mCapacity);
+		}
+
+		// delete copy and move, the atomics cannot be shared
+		SpscRingBuffer(const SpscRingBuffer& pOther) = delete;
+		SpscRingBuffer(SpscRingBuffer&& pOther) noexcept = delete;
+		SpscRingBuffer& operator=(const SpscRingBuffer& pOther) = delete;
+		SpscRingBuffer& operator=(SpscRingBuffer&& pOther) noexcept = delete;
+
+		/**
+		 * @return `false` if the buffer is full, the element is not added then.
+		 */
+		bool PushBack(const T& pElement) {
+			return EmplaceBack(pElement);
+		}
+
+		/**
+		 * @return `false` if the buffer is full, the element is not added then.
+		 */
+		bool PushBack(T&& pElement) {
+			return EmplaceBack(std::move(pElement));
+		}
+
+		/**
+		 * @return `false` if the buffer is full, the element is not added then.
+		 */
+		template<typename... Args>
+		bool EmplaceBack(Args&&... args) {
+			const size_t tail = mTail.Value.load(std::memory_order_relaxed);
+			if (tail - mProducerHeadCache.Value == mCapacity) {
+				mProducerHeadCache.Value = mHead.Value.load(std::memory_order_acquire);
+				if (tail - mProducerHeadCache.Value == mCapacity) {
+					return false;
+				}
+			}
+
+			new (mData + (tail & mMask)) T(std::forward<Args>(args)...);
+			mTail.Value.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * Move the oldest element into `pElement`.
+		 * @return `false` if the buffer is empty.
+		 */
+		bool TryPop(T& pElement) {
+			const size_t head = mHead.Value.load(std::memory_order_relaxed);
+			if (head == readableTail(head)) {
+				return false;
+			}
+
+			T* elem = mData + (head & mMask);
+			pElement = std::move(*elem);
+			elem->~T();
+			mHead.Value.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * Move as many elements as available (max `pOut.size()`) into `pOut`.
+		 * @return The number of elements written to `pOut`.
+		 */
+		size_t PopInto(std::span<T> pOut) {
+			const size_t head = mHead.Value.load(std::memory_order_relaxed);
+			const size_t available = readableTail(head) - head;
+			const size_t count = available < pOut.size() ? available : pOut.size();
+
+			for (size_t i = 0; i < count; ++i) {
+				T* elem = mData + ((head + i) & mMask);
+				pOut[i] = std::move(*elem);
+				elem->~T();
+			}
+
+			mHead.Value.store(head + count, std::memory_order_release);
+			return count;
+		}
+
+		/**
+		 * Remove all elements that are currently readable.
+		 */
+		void Clear() {
+			const size_t head = mHead.Value.load(std::memory_order_relaxed);
+			const size_t tail = mTail.Value.load(std::memory_order_acquire);
+			for (size_t i = head; i != tail; ++i) {
+				(mData + (i & mMask))->~T();
+			}
+			// `readableTail` only reloads when the head reaches the cache, a cache below the new head would never be reloaded
+			mConsumerTailCache.Value = tail;
+			mHead.Value.store(tail, std::memory_order_release);
+		}
+
+		[[nodiscard]] size_t Size() const {
+			const size_t head = mHead.Value.load(std::memory_order_acquire);
+			const size_t tail = mTail.Value.load(std::memory_order_acquire);
+			return tail - head;
+		}
+
+		[[nodiscard]] bool Empty() const {
+			return Size() == 0;
+		}
+
+		[[nodiscard]] size_t Capacity() const {
+			return mCapacity;
+		}
+
+		/**
+		 * Iterates over the elements that were readable, when `begin()` was called. Only use in the consumer thread.
+		 */
+		class SpscRingBufferIterator {
+		public:
+			using difference_type = std::ptrdiff_t;
+			using value_type = T;
+			using pointer = T*;
+			using reference = T&;
+			using iterator_category = std::forward_iterator_tag;
+
+			SpscRingBufferIterator() = default;
+			SpscRingBufferIterator(const SpscRingBuffer* pParent, size_t pIndex) : mParent(pParent), mIndex(pIndex) {}
+
+			bool operator==(const SpscRingBufferIterator&) const = default;
+
+			reference operator*() const { return mParent->mData[mIndex & mParent->mMask]; }
+			pointer operator->() const { return &**this; }
+
+			SpscRingBufferIterator& operator++() {
+				++mIndex;
+				return *this;
+			}
+
+			SpscRingBufferIterator operator++(int) {
+				SpscRingBufferIterator tmp = *this;
+				++mIndex;
+				return tmp;
+			}
+
+		private:
+			const SpscRingBuffer* mParent = nullptr;
+			size_t mIndex = 0;
+		};
+
+		static_assert(std::forward_iterator<SpscRingBufferIterator>);
+
+		SpscRingBufferIterator begin() const { return SpscRingBufferIterator(this, mHead.Value.load(std::memory_order_relaxed)); }
+		SpscRingBufferIterator end() const { return SpscRingBufferIterator(this, mTail.Value.load(std::memory_order_acquire)); }
+
+	private:
+		// every counter in its own cache line, so producer and consumer do not invalidate each other
+		template<typename V>
+		struct alignas(CacheLineSize) Padded {
+			V Value{};
+		};
+
+		const size_t mCapacity;
+		const size_t mMask;
+		T* mData = nullptr;
+		[[no_unique_address]] Allocator mAlloc;
+
+		Padded<std::atomic<size_t>> mHead;    // written by consumer
+		Padded<std::atomic<size_t>> mTail;    // written by producer
+		Padded<size_t> mProducerHeadCache;    // last head seen by the producer
+		Padded<size_t> mConsumerTailCache;    // last tail seen by the consumer
+
+		[[nodiscard]] size_t readableTail(size_t pHead) {
+			if (pHead == mConsumerTailCache.Value) {
+				mConsumerTailCache.Value = mTail.Value.load(std::memory_order_acquire);
+			}
+			return mConsumerTailCache.Value;
+		}
+	};
+} // namespace ArcdpsExtension
@@ -0,0 +1,100 @@
+#include "SimpleRingBuffer.h"
+#include "SpscRingBuffer.h"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <thread>
+
+using namespace ArcdpsExtension;
+
+namespace {
+	constexpr size_t Capacity = 1024;
+
+	/**
+	 * The way it is done without `SpscRingBuffer`: every access locks, the consumer copies everything out and clears the buffer.
+	 */
+	class MutexRingBuffer {
+	public:
+		explicit MutexRingBuffer(size_t pCapacity) : mCapacity(pCapacity), mBuffer(pCapacity) {}
+
+		bool PushBack(uint64_t pElement) {
+			std::lock_guard guard(mMutex);
+			if (mBuffer.Size() == mCapacity) {
+				return false;
+			}
+			mBuffer.PushBack(pElement);
+			return true;
+		}
+
+		size_t PopInto(std::span<uint64_t> pOut) {
+			std::lock_guard guard(mMutex);
+			size_t count = 0;
+			for (uint64_t element : mBuffer) {
+				if (count == pOut.size()) {
+					break;
+				}
+				pOut[count++] = element;
+			}
+			// not able to pop only a part, the benchmark always pops everything
+			mBuffer.Clear();
+			return count;
+		}
+
+	private:
+		std::mutex mMutex;
+		size_t mCapacity;
+		RingBuffer<uint64_t> mBuffer;
+	};
+
+	template<typename Buffer>
+	void Transfer(benchmark::State& pState) {
+		const auto count = static_cast<uint64_t>(pState.range(0));
+		for (auto _ : pState) {
+			Buffer buffer{Capacity};
+			std::jthread producer([&buffer, count] {
+				for (uint64_t i = 0; i < count; ++i) {
+					while (!buffer.PushBack(i)) {
+						std::this_thread::yield();
+					}
+				}
+			});
+
+			std::array<uint64_t, Capacity> out{};
+			uint64_t received = 0;
+			uint64_t sum = 0;
+			while (received < count) {
+				const size_t popped = buffer.PopInto(out);
+				if (popped == 0) {
+					std::this_thread::yield();
+				}
+				for (size_t i = 0; i < popped; ++i) {
+					sum += out[i];
+				}
+				received += popped;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		pState.SetItemsProcessed(pState.iterations() * static_cast<int64_t>(count));
+	}
+
+	template<typename Buffer>
+	void PushPopSingleThread(benchmark::State& pState) {
+		Buffer buffer{Capacity};
+		std::array<uint64_t, 1> out{};
+		uint64_t i = 0;
+		for (auto _ : pState) {
+			buffer.PushBack(i++);
+			buffer.PopInto(out);
+			benchmark::DoNotOptimize(out);
+		}
+		pState.SetItemsProcessed(pState.iterations());
+	}
+} // namespace
+
+BENCHMARK(Transfer<SpscRingBuffer<uint64_t>>)->Arg(1 << 20)->UseRealTime();
+BENCHMARK(Transfer<MutexRingBuffer>)->Arg(1 << 20)->UseRealTime();
+BENCHMARK(PushPopSingleThread<SpscRingBuffer<uint64_t>>);
+BENCHMARK(PushPopSingleThread<MutexRingBuffer>);
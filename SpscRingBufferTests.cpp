@@ -0,0 +1,138 @@
+#include "SpscRingBuffer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ArcdpsExtension;
+
+TEST(SpscRingBufferTests, CapacityTest) {
+	SpscRingBuffer<uint64_t> buffer(10);
+	EXPECT_EQ(buffer.Capacity(), 16);
+	EXPECT_TRUE(buffer.Empty());
+
+	for (uint64_t i = 0; i < 16; ++i) {
+		EXPECT_TRUE(buffer.PushBack(i));
+	}
+	EXPECT_FALSE(buffer.PushBack(16));
+	EXPECT_EQ(buffer.Size(), 16);
+}
+
+TEST(SpscRingBufferTests, TryPopTest) {
+	SpscRingBuffer<uint64_t> buffer(4);
+	uint64_t value = 0;
+	EXPECT_FALSE(buffer.TryPop(value));
+
+	// wrap around multiple times
+	for (uint64_t i = 0; i < 20; ++i) {
+		EXPECT_TRUE(buffer.PushBack(i));
+		EXPECT_TRUE(buffer.EmplaceBack(i + 100));
+		ASSERT_TRUE(buffer.TryPop(value));
+		EXPECT_EQ(value, i);
+		ASSERT_TRUE(buffer.TryPop(value));
+		EXPECT_EQ(value, i + 100);
+	}
+	EXPECT_TRUE(buffer.Empty());
+}
+
+TEST(SpscRingBufferTests, PopIntoTest) {
+	SpscRingBuffer<uint64_t> buffer(8);
+	for (uint64_t i = 1; i < 7; ++i) {
+		buffer.PushBack(i);
+	}
+
+	std::array<uint64_t, 4> out{};
+	EXPECT_EQ(buffer.PopInto(out), 4);
+	EXPECT_EQ(out, (std::array<uint64_t, 4>{1, 2, 3, 4}));
+	EXPECT_EQ(buffer.PopInto(out), 2);
+	EXPECT_EQ(out[0], 5);
+	EXPECT_EQ(out[1], 6);
+	EXPECT_EQ(buffer.PopInto(out), 0);
+}
+
+TEST(SpscRingBufferTests, IteratorTest) {
+	SpscRingBuffer<uint64_t> buffer(4);
+	for (uint64_t i = 1; i < 4; ++i) {
+		buffer.PushBack(i);
+	}
+	uint64_t value;
+	buffer.TryPop(value);
+	buffer.PushBack(4);
+	buffer.PushBack(5);
+
+	EXPECT_TRUE(std::ranges::equal(buffer, std::vector<uint64_t>{2, 3, 4, 5}));
+}
+
+TEST(SpscRingBufferTests, NonTrivialTest) {
+	auto counter = std::make_shared<int>(0);
+	{
+		SpscRingBuffer<std::shared_ptr<int>> buffer(4);
+		buffer.PushBack(counter);
+		buffer.PushBack(counter);
+		buffer.EmplaceBack(counter);
+		EXPECT_EQ(counter.use_count(), 4);
+
+		std::shared_ptr<int> out;
+		buffer.TryPop(out);
+		out.reset();
+		EXPECT_EQ(counter.use_count(), 3);
+	}
+	// destructor releases the remaining elements
+	EXPECT_EQ(counter.use_count(), 1);
+
+	SpscRingBuffer<std::string> strings(2);
+	strings.EmplaceBack(3, 'a');
+	strings.Clear();
+	EXPECT_TRUE(strings.Empty());
+}
+
+TEST(SpscRingBufferTests, ClearTest) {
+	SpscRingBuffer<int> buffer(8);
+	buffer.PushBack(1);
+	buffer.PushBack(2);
+	buffer.PushBack(3);
+	buffer.Clear();
+
+	int out = 0;
+	EXPECT_FALSE(buffer.TryPop(out));
+	std::array<int, 8> many{};
+	EXPECT_EQ(buffer.PopInto(many), 0);
+	EXPECT_EQ(buffer.Size(), 0);
+
+	// still usable afterwards
+	buffer.PushBack(4);
+	EXPECT_TRUE(buffer.TryPop(out));
+	EXPECT_EQ(out, 4);
+	EXPECT_FALSE(buffer.TryPop(out));
+}
+
+TEST(SpscRingBufferTests, ConcurrentTest) {
+	constexpr uint64_t count = 200'000;
+	SpscRingBuffer<uint64_t> buffer(1024);
+
+	std::jthread producer([&buffer] {
+		for (uint64_t i = 0; i < count; ++i) {
+			while (!buffer.PushBack(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	uint64_t expected = 0;
+	std::array<uint64_t, 64> out{};
+	while (expected < count) {
+		const size_t popped = buffer.PopInto(out);
+		if (popped == 0) {
+			std::this_thread::yield();
+		}
+		for (size_t i = 0; i < popped; ++i) {
+			ASSERT_EQ(out[i], expected++);
+		}
+	}
+	EXPECT_TRUE(buffer.Empty());
+}
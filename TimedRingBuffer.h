@@ -0,0 +1,110 @@
+#pragma once
+
+#include "SimpleRingBuffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <utility>
+
+namespace ArcdpsExtension {
+	/**
+	 * Default projection of `TimedRingBuffer`, uses the `time` member (e.g. of `cbtevent`).
+	 */
+	struct TimeMember {
+		template<typename T>
+		constexpr uint64_t operator()(const T& pElement) const {
+			return pElement.time;
+		}
+	};
+
+	/**
+	 * Ring buffer of timestamped samples, that are ordered by time.
+	 * `PushBack()` only accepts samples that are not older than the newest one, so the content is always sorted
+	 * and "all samples since t" is a binary search instead of a walk over the whole buffer.
+	 * <br>
+	 * Based on `MaskedRingBuffer`, so the capacity is rounded up to the next power of two.
+	 *
+	 * @tparam T The type that this buffer holds.
+	 * @tparam Projection Returns the time of an element.
+	 */
+	template<typename T, typename Projection = TimeMember, typename Allocator = std::allocator<T>>
+	class TimedRingBuffer {
+	public:
+		using const_iterator = typename MaskedRingBuffer<T, Allocator>::const_iterator;
+
+		explicit TimedRingBuffer(size_t pInitialCapacity, Projection pProjection = {})
+			: mBuffer(pInitialCapacity),
+			  mProjection(std::move(pProjection)) {}
+
+		/**
+		 * @return `false` if the element is older than `Back()`, it is not added then.
+		 */
+		bool PushBack(const T& pElement) {
+			if (!inOrder(pElement)) return false;
+			mBuffer.PushBack(pElement);
+			return true;
+		}
+
+		/**
+		 * @return `false` if the element is older than `Back()`, it is not added then.
+		 */
+		bool PushBack(T&& pElement) {
+			if (!inOrder(pElement)) return false;
+			mBuffer.PushBack(std::move(pElement));
+			return true;
+		}
+
+		/**
+		 * @return First element with a time >= `pTime`, `end()` if there is none.
+		 */
+		[[nodiscard]] const_iterator LowerBound(uint64_t pTime) const {
+			return std::ranges::lower_bound(mBuffer, pTime, {}, std::ref(mProjection));
+		}
+
+		/**
+		 * @return First element with a time > `pTime`, `end()` if there is none.
+		 */
+		[[nodiscard]] const_iterator UpperBound(uint64_t pTime) const {
+			return std::ranges::upper_bound(mBuffer, pTime, {}, std::ref(mProjection));
+		}
+
+		/**
+		 * @return All elements with a time >= `pTime`, oldest first.
+		 */
+		[[nodiscard]] std::ranges::subrange<const_iterator> RangeSince(uint64_t pTime) const {
+			return {LowerBound(pTime), end()};
+		}
+
+		/**
+		 * @return All elements with `pBegin` <= time < `pEnd`, oldest first.
+		 */
+		[[nodiscard]] std::ranges::subrange<const_iterator> RangeBetween(uint64_t pBegin, uint64_t pEnd) const {
+			const auto first = LowerBound(pBegin);
+			const auto last = std::ranges::lower_bound(first, end(), pEnd, {}, std::ref(mProjection));
+			return {first, last};
+		}
+
+		[[nodiscard]] const T& Back() const { return mBuffer.Back(); }
+		[[nodiscard]] const T& operator[](size_t pNum) const { return mBuffer[pNum]; }
+		[[nodiscard]] size_t Size() const { return mBuffer.Size(); }
+		[[nodiscard]] size_t Capacity() const { return mBuffer.Capacity(); }
+		[[nodiscard]] auto Segments() const { return mBuffer.Segments(); }
+		void Clear() { mBuffer.Clear(); }
+
+		// elements are only accessible as const, changing the time would break the order
+		const_iterator begin() const { return mBuffer.begin(); }
+		const_iterator end() const { return mBuffer.end(); }
+
+	private:
+		MaskedRingBuffer<T, Allocator> mBuffer;
+		Projection mProjection;
+
+		[[nodiscard]] bool inOrder(const T& pElement) const {
+			return mBuffer.Size() == 0 || mProjection(mBuffer.Back()) <= mProjection(pElement);
+		}
+	};
+} // namespace ArcdpsExtension
@@ -0,0 +1,76 @@
+#include "arcdps_structs_slim.h"
+#include "TimedRingBuffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <ranges>
+#include <vector>
+
+using namespace ArcdpsExtension;
+
+namespace {
+	struct Sample {
+		uint64_t Time;
+		int Value;
+	};
+
+	struct SampleTime {
+		uint64_t operator()(const Sample& pSample) const {
+			return pSample.Time;
+		}
+	};
+
+	std::vector<int> Values(auto&& pRange) {
+		std::vector<int> res;
+		for (const Sample& sample : pRange) {
+			res.push_back(sample.Value);
+		}
+		return res;
+	}
+} // namespace
+
+TEST(TimedRingBufferTests, MonotonicTest) {
+	TimedRingBuffer<Sample, SampleTime> buffer(4);
+	EXPECT_TRUE(buffer.PushBack({10, 1}));
+	EXPECT_TRUE(buffer.PushBack({10, 2}));
+	EXPECT_TRUE(buffer.PushBack({20, 3}));
+	EXPECT_FALSE(buffer.PushBack({15, 4}));
+
+	EXPECT_EQ(buffer.Size(), 3);
+	EXPECT_EQ(buffer.Back().Value, 3);
+}
+
+TEST(TimedRingBufferTests, RangeSinceTest) {
+	TimedRingBuffer<Sample, SampleTime> buffer(8);
+	// wraps, oldest are 40 and 50
+	for (int i = 1; i <= 11; ++i) {
+		buffer.PushBack({static_cast<uint64_t>(i * 10), i});
+	}
+
+	EXPECT_EQ(buffer.LowerBound(0), buffer.begin());
+	EXPECT_EQ(buffer.LowerBound(1000), buffer.end());
+	EXPECT_EQ(buffer.LowerBound(55)->Value, 6);
+	EXPECT_EQ(buffer.LowerBound(60)->Value, 6);
+	EXPECT_EQ(buffer.UpperBound(60)->Value, 7);
+
+	EXPECT_EQ(Values(buffer.RangeSince(85)), (std::vector<int>{9, 10, 11}));
+	EXPECT_EQ(Values(buffer.RangeSince(0)), (std::vector<int>{4, 5, 6, 7, 8, 9, 10, 11}));
+	EXPECT_TRUE(buffer.RangeSince(111).empty());
+
+	EXPECT_EQ(Values(buffer.RangeBetween(50, 80)), (std::vector<int>{5, 6, 7}));
+	EXPECT_TRUE(buffer.RangeBetween(81, 89).empty());
+}
+
+TEST(TimedRingBufferTests, CbteventTest) {
+	TimedRingBuffer<cbtevent> buffer(16);
+	for (uint64_t time = 1000; time < 1100; time += 5) {
+		cbtevent event{};
+		event.time = time;
+		buffer.PushBack(event);
+	}
+
+	const auto since = buffer.RangeSince(1080);
+	EXPECT_EQ(std::ranges::distance(since), 4);
+	EXPECT_EQ(since.begin()->time, 1080);
+}
@@ -6,11 +6,13 @@ target_sources(${PROJECT_NAME}
 		PUBLIC
 		FILE_SET HEADERS
 		FILES
+		HttpCache.h
 		SimpleNetworkStack.h
 )
 
 target_sources(${PROJECT_NAME}
 		PRIVATE
+		HttpCache.cpp
 		SimpleNetworkStack.cpp
 )
 
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace ArcdpsExtension::Test {
+	struct HttpRequest {
+		std::string Method;
+		std::string Target;
+		// header names are lowercase
+		std::map<std::string, std::string> Headers;
+
+		[[nodiscard]] std::string Header(const std::string& pName) const {
+			auto it = Headers.find(pName);
+			return it == Headers.end() ? "" : it->second;
+		}
+	};
+
+	struct HttpReply {
+		int Code = 200;
+		std::string Body;
+		std::vector<std::pair<std::string, std::string>> Headers{};
+		// wait before answering, to simulate a slow server
+		std::chrono::milliseconds Delay{0};
+	};
+
+	/**
+	 * Minimal HTTP/1.1 server on `127.0.0.1`, as stand-in for real servers in tests and benchmarks.
+	 * Every connection gets its own thread, connections are kept alive.
+	 * The handler is called from these threads, so it has to be thread-safe.
+	 * <br>
+	 * Usage:
+	 * @code
+	 * LocalHttpServer server([](const HttpRequest& pRequest) {
+	 * 	return HttpReply{200, "hello"};
+	 * });
+	 * networkStack.QueueGet(server.Url("/hello"), ...);
+	 * @endcode
+	 */
+	class LocalHttpServer {
+	public:
+		using Handler = std::function<HttpReply(const HttpRequest&)>;
+
+		explicit LocalHttpServer(Handler pHandler) : mHandler(std::move(pHandler)) {
+#ifdef _WIN32
+			WSADATA wsaData;
+			WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+			mListenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+			if (mListenSocket == InvalidSocket) {
+				throw std::runtime_error("Failed to create socket");
+			}
+
+			sockaddr_in address{};
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			address.sin_port = 0;
+			socklen_t length = sizeof(address);
+			if (bind(mListenSocket, reinterpret_cast<sockaddr*>(&address), length) != 0
+				|| listen(mListenSocket, SOMAXCONN) != 0
+				|| getsockname(mListenSocket, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+				closeSocket(mListenSocket);
+				throw std::runtime_error("Failed to listen on local socket");
+			}
+			mPort = ntohs(address.sin_port);
+
+			mAcceptThread = std::thread([this] { acceptLoop(); });
+		}
+
+		~LocalHttpServer() {
+			mStopped = true;
+			shutdownSocket(mListenSocket);
+			closeSocket(mListenSocket);
+			mAcceptThread.join();
+
+			std::vector<std::thread> threads;
+			{
+				std::lock_guard guard(mMutex);
+				for (Socket socket : mClientSockets) {
+					shutdownSocket(socket);
+				}
+				threads = std::move(mClientThreads);
+			}
+			for (auto& thread : threads) {
+				thread.join();
+			}
+#ifdef _WIN32
+			WSACleanup();
+#endif
+		}
+
+		LocalHttpServer(const LocalHttpServer& pOther) = delete;
+		LocalHttpServer(LocalHttpServer&& pOther) noexcept = delete;
+		LocalHttpServer& operator=(const LocalHttpServer& pOther) = delete;
+		LocalHttpServer& operator=(LocalHttpServer&& pOther) noexcept = delete;
+
+		[[nodiscard]] uint16_t Port() const { return mPort; }
+
+		/**
+		 * @param pTarget Path and query, starting with '/'.
+		 */
+		[[nodiscard]] std::string Url(std::string_view pTarget) const {
+			return std::format("http://127.0.0.1:{}{}", mPort, pTarget);
+		}
+
+		/**
+		 * @return Number of requests answered so far.
+		 */
+		[[nodiscard]] size_t RequestCount() const { return mRequestCount.load(); }
+
+		/**
+		 * @return Number of accepted connections so far.
+		 */
+		[[nodiscard]] size_t ConnectionCount() const { return mConnectionCount.load(); }
+
+	private:
+#ifdef _WIN32
+		using Socket = SOCKET;
+		static constexpr Socket InvalidSocket = INVALID_SOCKET;
+#else
+		using Socket = int;
+		static constexpr Socket InvalidSocket = -1;
+#endif
+
+		Handler mHandler;
+		Socket mListenSocket = InvalidSocket;
+		uint16_t mPort = 0;
+		std::atomic_bool mStopped = false;
+		std::atomic_size_t mRequestCount = 0;
+		std::atomic_size_t mConnectionCount = 0;
+		std::thread mAcceptThread;
+		std::mutex mMutex;
+		std::vector<Socket> mClientSockets;
+		std::vector<std::thread> mClientThreads;
+
+		static void closeSocket(Socket pSocket) {
+#ifdef _WIN32
+			closesocket(pSocket);
+#else
+			close(pSocket);
+#endif
+		}
+
+		static void shutdownSocket(Socket pSocket) {
+#ifdef _WIN32
+			shutdown(pSocket, SD_BOTH);
+#else
+			shutdown(pSocket, SHUT_RDWR);
+#endif
+		}
+
+		void acceptLoop() {
+			while (!mStopped) {
+				Socket client = accept(mListenSocket, nullptr, nullptr);
+				if (client == InvalidSocket) {
+					continue;
+				}
+				++mConnectionCount;
+
+				std::lock_guard guard(mMutex);
+				if (mStopped) {
+					closeSocket(client);
+					break;
+				}
+				mClientSockets.emplace_back(client);
+				mClientThreads.emplace_back([this, client] { serve(client); });
+			}
+		}
+
+		void serve(Socket pSocket) {
+			std::string buffer;
+			char chunk[4096];
+			while (!mStopped) {
+				size_t headerEnd = buffer.find("\r\n\r\n");
+				if (headerEnd == std::string::npos) {
+					const auto received = recv(pSocket, chunk, sizeof(chunk), 0);
+					if (received <= 0) {
+						break;
+					}
+					buffer.append(chunk, static_cast<size_t>(received));
+					continue;
+				}
+
+				HttpRequest request = parse(std::string_view(buffer).substr(0, headerEnd));
+				// GET requests only, there is no body to skip
+				buffer.erase(0, headerEnd + 4);
+
+				HttpReply reply = mHandler(request);
+				if (reply.Delay.count() > 0) {
+					std::this_thread::sleep_for(reply.Delay);
+				}
+				++mRequestCount;
+
+				std::string response = std::format("HTTP/1.1 {} Status\r\nContent-Length: {}\r\n", reply.Code, reply.Body.size());
+				for (const auto& [name, value] : reply.Headers) {
+					response.append(std::format("{}: {}\r\n", name, value));
+				}
+				response.append("\r\n");
+				if (request.Method != "HEAD") {
+					response.append(reply.Body);
+				}
+				if (!sendAll(pSocket, response) || request.Header("connection") == "close") {
+					break;
+				}
+			}
+
+			std::lock_guard guard(mMutex);
+			std::erase(mClientSockets, pSocket);
+			closeSocket(pSocket);
+		}
+
+		static bool sendAll(Socket pSocket, std::string_view pData) {
+			while (!pData.empty()) {
+#ifdef _WIN32
+				const auto sent = send(pSocket, pData.data(), static_cast<int>(pData.size()), 0);
+#else
+				// the client might have aborted, that must not raise SIGPIPE
+				const auto sent = send(pSocket, pData.data(), pData.size(), MSG_NOSIGNAL);
+#endif
+				if (sent <= 0) {
+					return false;
+				}
+				pData.remove_prefix(static_cast<size_t>(sent));
+			}
+			return true;
+		}
+
+		static HttpRequest parse(std::string_view pHead) {
+			HttpRequest request;
+			size_t lineEnd = pHead.find("\r\n");
+			std::string_view requestLine = pHead.substr(0, lineEnd);
+			const size_t methodEnd = requestLine.find(' ');
+			const size_t targetEnd = requestLine.find(' ', methodEnd + 1);
+			request.Method = requestLine.substr(0, methodEnd);
+			request.Target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+
+			while (lineEnd != std::string_view::npos) {
+				pHead.remove_prefix(lineEnd + 2);
+				lineEnd = pHead.find("\r\n");
+				std::string_view line = pHead.substr(0, lineEnd);
+				const size_t colon = line.find(':');
+				if (colon == std::string_view::npos) {
+					continue;
+				}
+				std::string name(line.substr(0, colon));
+				std::ranges::transform(name, name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+				std::string_view value = line.substr(colon + 1);
+				while (!value.empty() && value.front() == ' ') {
+					value.remove_prefix(1);
+				}
+				request.Headers[name] = value;
+			}
+			return request;
+		}
+	};
+} // namespace ArcdpsExtension::Test